@@ -185,14 +185,22 @@ typedef struct {
     /** mpy data follows thereafter. */
 } mpy_info_t;
 
+/** Index entry to look up a script by name. */
+typedef struct {
+    /** Hash of the script name, as computed by qstr_compute_hash(). */
+    size_t hash;
+    /** The script with this name. */
+    mpy_info_t *info;
+} mpy_index_entry_t;
+
 // Program data is a concatenation of multiple mpy files. This sets a reference
 // to the first script and the total size so we can search for modules.
 static mpy_info_t *mpy_first;
 static mpy_info_t *mpy_end;
-static inline void mpy_data_init(pbsys_main_program_t *program) {
-    mpy_first = (mpy_info_t *)program->code_start;
-    mpy_end = (mpy_info_t *)program->code_end;
-}
+
+// Index of all scripts, sorted by the hash of their names.
+static mpy_index_entry_t *mpy_index;
+static size_t mpy_index_len;
 
 /**
  * Gets a reference to the mpy data of a script.
@@ -204,6 +212,60 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
     return (uint8_t *)info + sizeof(info->mpy_size) + strlen(info->mpy_name) + 1;
 }
 
+/**
+ * Gets a reference to the next script in the program data.
+ * @param [in]  info    A pointer to an mpy info header.
+ * @return              A pointer to the next mpy info header.
+ */
+static mpy_info_t *mpy_data_get_next(mpy_info_t *info) {
+    return (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size));
+}
+
+/**
+ * Sets up the program data and builds an index of the scripts in it, so that
+ * modules can be found without scanning all data on every import.
+ *
+ * The index is stored in RAM directly after the program data.
+ *
+ * @param [in]  program The program data.
+ * @return              The first address after the index, aligned so it can be
+ *                      used as the start of the heap.
+ */
+static uint8_t *mpy_data_init(pbsys_main_program_t *program) {
+    mpy_first = (mpy_info_t *)program->code_start;
+    mpy_end = (mpy_info_t *)program->code_end;
+
+    // Count the scripts.
+    size_t len = 0;
+    for (mpy_info_t *info = mpy_first; info < mpy_end; info = mpy_data_get_next(info)) {
+        len++;
+    }
+
+    // Reserve aligned space for the index. If it does not fit, modules are
+    // found by scanning the program data instead.
+    uintptr_t align = sizeof(mpy_index_entry_t *);
+    mpy_index = (mpy_index_entry_t *)(((uintptr_t)program->code_end + align - 1) & ~(align - 1));
+    mpy_index_len = 0;
+    if ((uint8_t *)(mpy_index + len) > (uint8_t *)program->data_end) {
+        mpy_index = NULL;
+        return program->code_end;
+    }
+
+    // Add each script, keeping the index sorted by hash. There are usually
+    // only a few dozen scripts, so insertion sort is sufficient.
+    for (mpy_info_t *info = mpy_first; info < mpy_end; info = mpy_data_get_next(info)) {
+        size_t hash = qstr_compute_hash((const byte *)info->mpy_name, strlen(info->mpy_name));
+        size_t i = mpy_index_len++;
+        for (; i > 0 && mpy_index[i - 1].hash > hash; i--) {
+            mpy_index[i] = mpy_index[i - 1];
+        }
+        mpy_index[i].hash = hash;
+        mpy_index[i].info = info;
+    }
+
+    return (uint8_t *)(mpy_index + mpy_index_len);
+}
+
 /**
  * Finds a MicroPython module in the program data.
  * @param [in]  name    The fully qualified name of the module.
@@ -211,12 +273,36 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
  *                      module was not found.
  */
 static mpy_info_t *mpy_data_find(qstr name) {
-    const char *name_str = qstr_str(name);
+    size_t name_len;
+    const char *name_str = (const char *)qstr_data(name, &name_len);
+
+    // Without an index, scan all scripts.
+    if (!mpy_index) {
+        for (mpy_info_t *info = mpy_first; info < mpy_end; info = mpy_data_get_next(info)) {
+            if (strcmp(info->mpy_name, name_str) == 0) {
+                return info;
+            }
+        }
+        return NULL;
+    }
+
+    // Find the first entry with a matching hash.
+    size_t hash = qstr_compute_hash((const byte *)name_str, name_len);
+    size_t lo = 0;
+    size_t hi = mpy_index_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (mpy_index[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
 
-    for (mpy_info_t *info = mpy_first; info < mpy_end;
-         info = (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size))) {
-        if (strcmp(info->mpy_name, name_str) == 0) {
-            return info;
+    // Different names may have the same hash, so compare all of them.
+    for (; lo < mpy_index_len && mpy_index[lo].hash == hash; lo++) {
+        if (strcmp(mpy_index[lo].info->mpy_name, name_str) == 0) {
+            return mpy_index[lo].info;
         }
     }
 
@@ -305,12 +391,12 @@ void pbsys_main_run_program(pbsys_main_program_t *program) {
     mp_stack_set_top(estack);
     mp_stack_set_limit(estack - sstack - 1024);
 
-    // MicroPython heap starts after program data.
-    gc_init(program->code_end, program->data_end);
+    // Set program data reference to first script and index all scripts. This
+    // is used to run main, and to find downloaded modules.
+    uint8_t *heap_start = mpy_data_init(program);
 
-    // Set program data reference to first script. This is used to run main,
-    // and to set the starting point for finding downloaded modules.
-    mpy_data_init(program);
+    // MicroPython heap starts after program data and its index.
+    gc_init(heap_start, program->data_end);
 
     // Initialize MicroPython.
     mp_init();
@@ -50,7 +50,9 @@
 #define MICROPY_DEBUG_PRINTERS                  (0)
 #define MICROPY_ENABLE_GC                       (1)
 #define MICROPY_ENABLE_FINALISER                (1)
+#ifndef MICROPY_GC_ALLOC_THRESHOLD
 #define MICROPY_GC_ALLOC_THRESHOLD              (0)
+#endif
 #define MICROPY_STACK_CHECK                     (1)
 #define MICROPY_HELPER_REPL                     (1)
 #define MICROPY_HELPER_LEXER_UNIX               (0)
@@ -94,6 +94,7 @@ PYBRICKS_PYBRICKS_SRC_C = $(addprefix pybricks/,\
 	pybricks.c \
 	robotics/pb_module_robotics.c \
 	robotics/pb_type_drivebase.c \
+	robotics/pb_type_motorgroup.c \
 	robotics/pb_type_spikebase.c \
 	tools/pb_module_tools.c \
 	tools/pb_type_awaitable.c \
@@ -197,6 +198,7 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	src/differentiator.c \
 	src/drivebase.c \
 	src/error.c \
+	src/event.c \
 	src/geometry.c \
 	src/imu.c \
 	src/int_math.c \
@@ -206,6 +208,7 @@ PBIO_SRC_C = $(addprefix lib/pbio/,\
 	src/light/light_matrix.c \
 	src/logger.c \
 	src/main.c \
+	src/motion_group.c \
 	src/motor_process.c \
 	src/motor/servo_settings.c \
 	src/observer.c \
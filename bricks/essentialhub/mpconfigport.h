@@ -41,6 +41,7 @@
 #define PYBRICKS_PY_ROBOTICS                    (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_GYRO     (1)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE    (1)
+#define PYBRICKS_PY_ROBOTICS_MOTORGROUP         (1)
 #define PYBRICKS_PY_TOOLS                       (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU              (0)
 
@@ -52,4 +53,9 @@
 #define PYBRICKS_OPT_CUSTOM_IMPORT              (1)
 #define PYBRICKS_OPT_NATIVE_MOD                 (0)
 
+// MicroPython options
+// Count allocations so run_task() can skip collections if nothing was
+// allocated. The automatic collection threshold stays disabled.
+#define MICROPY_GC_ALLOC_THRESHOLD              (1)
+
 #include "../_common_stm32/mpconfigport.h"
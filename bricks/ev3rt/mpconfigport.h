@@ -42,6 +42,7 @@
 #define PYBRICKS_PY_PUPDEVICES          (0)
 #define PYBRICKS_PY_ROBOTICS            (0)
 #define PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE (0)
+#define PYBRICKS_PY_ROBOTICS_MOTORGROUP (0)
 #define PYBRICKS_PY_TOOLS               (1)
 #define PYBRICKS_PY_TOOLS_HUB_MENU      (0)
 
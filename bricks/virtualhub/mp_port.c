@@ -15,6 +15,7 @@
 #include <contiki.h>
 
 #include <pbio/main.h>
+#include <pbdrv/clock.h>
 #include <pbdrv/legodev.h>
 #include <pbsys/core.h>
 #include <pbsys/program_stop.h>
@@ -85,10 +86,24 @@ void pb_virtualhub_port_deinit(void) {
     pb_package_pybricks_deinit();
 }
 
+// In simulated time mode, time does not pass while the program runs, so a
+// busy loop waiting for a motor or a stopwatch would never end. Instead, let
+// one tick pass for this many iterations of the VM loop, as if each one took
+// some time. This keeps runs reproducible since it does not depend on the
+// speed of the computer.
+#define SIMULATED_LOOPS_PER_TICK (100)
+
 // MICROPY_VM_HOOK_LOOP
 void pb_virtualhub_poll(void) {
+    static uint32_t simulated_loops;
+
     while (pbio_do_one_event()) {
     }
+
+    if (pbdrv_clock_is_simulated() && ++simulated_loops >= SIMULATED_LOOPS_PER_TICK) {
+        simulated_loops = 0;
+        pbdrv_clock_simulated_advance_us(1000);
+    }
 }
 
 // MICROPY_EVENT_POLL_HOOK
@@ -121,6 +136,14 @@ start:
         goto start;
     }
 
+    // In simulated time mode, there is nothing to wait for. Advance the
+    // clock right away so that the next tick is handled without delay.
+    if (pbdrv_clock_is_simulated()) {
+        pthread_sigmask(SIG_SETMASK, &origmask, NULL);
+        pbdrv_clock_simulated_advance_us(1000);
+        return;
+    }
+
     struct timespec timeout = {
         .tv_sec = 0,
         .tv_nsec = 100000,
@@ -138,9 +161,16 @@ start:
 
 void pb_virtualhub_delay_us(mp_uint_t us) {
     mp_uint_t start = mp_hal_ticks_us();
+    mp_uint_t elapsed;
 
-    while (mp_hal_ticks_us() - start < us) {
-        pb_virtualhub_poll();
+    while ((elapsed = mp_hal_ticks_us() - start) < us) {
+        while (pbio_do_one_event()) {
+        }
+        // Simulated time only passes when the clock is advanced. Step by
+        // the remaining time, but no more than one tick so that etimers
+        // still run on each tick.
+        mp_uint_t step = us - elapsed;
+        pbdrv_clock_simulated_advance_us(step < 1000 ? step : 1000);
     }
 }
 
@@ -97,19 +97,22 @@ PRESCALE_CURRENT = INT32_MAX // MAX_NUM_CURRENT
 PRESCALE_VOLTAGE = INT32_MAX // MAX_NUM_VOLTAGE
 PRESCALE_TORQUE = INT32_MAX // MAX_NUM_TORQUE
 
+# Number of fractional bits of the reciprocals used in the observer update.
+RECIPROCAL_SHIFT = 24
+
 HEADER = textwrap.dedent(
     f"""
     // Values generated by pbio/doc/control/model.py
-    #define MAX_NUM_SPEED ({MAX_NUM_SPEED})
-    #define MAX_NUM_ACCELERATION ({MAX_NUM_ACCELERATION})
-    #define MAX_NUM_CURRENT ({MAX_NUM_CURRENT})
-    #define MAX_NUM_VOLTAGE ({MAX_NUM_VOLTAGE})
-    #define MAX_NUM_TORQUE ({MAX_NUM_TORQUE})
-    #define PRESCALE_SPEED ({PRESCALE_SPEED})
-    #define PRESCALE_ACCELERATION ({PRESCALE_ACCELERATION})
-    #define PRESCALE_CURRENT ({PRESCALE_CURRENT})
-    #define PRESCALE_VOLTAGE ({PRESCALE_VOLTAGE})
-    #define PRESCALE_TORQUE ({PRESCALE_TORQUE})
+    #define PBIO_OBSERVER_MAX_NUM_SPEED ({MAX_NUM_SPEED})
+    #define PBIO_OBSERVER_MAX_NUM_ACCELERATION ({MAX_NUM_ACCELERATION})
+    #define PBIO_OBSERVER_MAX_NUM_CURRENT ({MAX_NUM_CURRENT})
+    #define PBIO_OBSERVER_MAX_NUM_VOLTAGE ({MAX_NUM_VOLTAGE})
+    #define PBIO_OBSERVER_MAX_NUM_TORQUE ({MAX_NUM_TORQUE})
+    #define PBIO_OBSERVER_PRESCALE_SPEED ({PRESCALE_SPEED})
+    #define PBIO_OBSERVER_PRESCALE_ACCELERATION ({PRESCALE_ACCELERATION})
+    #define PBIO_OBSERVER_PRESCALE_CURRENT ({PRESCALE_CURRENT})
+    #define PBIO_OBSERVER_PRESCALE_VOLTAGE ({PRESCALE_VOLTAGE})
+    #define PBIO_OBSERVER_PRESCALE_TORQUE ({PRESCALE_TORQUE})
 
     typedef struct _pbio_observer_model_t {{
         int32_t d_angle_d_speed;
@@ -134,8 +137,8 @@ HEADER = textwrap.dedent(
 )
 
 
-def make_model(name, *, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm, h):
-    """Initialize the model using experimental data"""
+def get_parameters(*, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm):
+    """Gets the physical motor parameters and friction from experimental data"""
 
     # Compute system parameters from motor curve data:
     model = {}
@@ -150,6 +153,12 @@ def make_model(name, *, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm, h):
     model[In] = (model[Kt] * V / model[R] - tau_s) / a
     model[L] = Lm
 
+    return model, tau_s
+
+
+def get_system_matrices(model, h):
+    """Gets the discrete time system matrices for sample time h"""
+
     # Substitute parameters into model to get numeric system matrices
     exponent_numeric = numpy.array(exponent.subs(model).evalf().tolist()).astype(numpy.float64)
 
@@ -157,6 +166,14 @@ def make_model(name, *, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm, h):
     exponential = scipy.linalg.expm(exponent_numeric * h)
     A = exponential[0:3, 0:3]
     B = exponential[0:3, 3:5]
+    return A, B
+
+
+def make_model(name, *, h, **data):
+    """Initialize the model using experimental data"""
+
+    model, tau_s = get_parameters(**data)
+    A, B = get_system_matrices(model, h)
 
     # Matrix multiplication goes like this, e.g. for the first row:
     #
@@ -171,26 +188,95 @@ def make_model(name, *, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm, h):
     #
     # The term (speed_prescale / a_01) is stored as a single integer.
     #
+    # The observer update runs on every control loop, so it uses fixed-point
+    # reciprocals of these terms instead, to avoid divisions:
+    #
+    # angle_next = speed * round(speed_prescale * 2**shift / d_angle_d_speed) >> shift
+    #
+    matrix = {
+        "angle_d_speed": round(PRESCALE_SPEED / A[0, 1]),
+        "speed_d_speed": round(PRESCALE_SPEED / A[1, 1]),
+        "current_d_speed": round(PRESCALE_SPEED / A[2, 1]),
+        "angle_d_current": round(PRESCALE_CURRENT / A[0, 2]),
+        "speed_d_current": round(PRESCALE_CURRENT / A[1, 2]),
+        "current_d_current": round(PRESCALE_CURRENT / A[2, 2]),
+        "angle_d_voltage": round(PRESCALE_VOLTAGE / B[0, 0]),
+        "speed_d_voltage": round(PRESCALE_VOLTAGE / B[1, 0]),
+        "current_d_voltage": round(PRESCALE_VOLTAGE / B[2, 0]),
+        "angle_d_torque": round(PRESCALE_TORQUE / B[0, 1]),
+        "speed_d_torque": round(PRESCALE_TORQUE / B[1, 1]),
+        "current_d_torque": round(PRESCALE_TORQUE / B[2, 1]),
+    }
+    prescale = {
+        "speed": PRESCALE_SPEED,
+        "current": PRESCALE_CURRENT,
+        "voltage": PRESCALE_VOLTAGE,
+        "torque": PRESCALE_TORQUE,
+    }
+    reciprocals = {
+        key: round(prescale[key.split("_d_")[1]] * 2**RECIPROCAL_SHIFT / value)
+        for key, value in matrix.items()
+    }
+    assert all(abs(value) < 2**31 for value in reciprocals.values())
+
     return textwrap.dedent(
         f"""
         static const pbio_observer_model_t model_{name} = {{
-            .d_angle_d_speed = {round(PRESCALE_SPEED / A[0, 1])},
-            .d_speed_d_speed = {round(PRESCALE_SPEED / A[1, 1])},
-            .d_current_d_speed = {round(PRESCALE_SPEED / A[2, 1])},
-            .d_angle_d_current = {round(PRESCALE_CURRENT / A[0, 2])},
-            .d_speed_d_current = {round(PRESCALE_CURRENT / A[1, 2])},
-            .d_current_d_current = {round(PRESCALE_CURRENT / A[2, 2])},
-            .d_angle_d_voltage = {round(PRESCALE_VOLTAGE / B[0, 0])},
-            .d_speed_d_voltage = {round(PRESCALE_VOLTAGE / B[1, 0])},
-            .d_current_d_voltage = {round(PRESCALE_VOLTAGE / B[2, 0])},
-            .d_angle_d_torque = {round(PRESCALE_TORQUE / B[0, 1])},
-            .d_speed_d_torque = {round(PRESCALE_TORQUE / B[1, 1])},
-            .d_current_d_torque = {round(PRESCALE_TORQUE / B[2, 1])},
+            .d_angle_d_speed = {matrix["angle_d_speed"]},
+            .d_speed_d_speed = {matrix["speed_d_speed"]},
+            .d_current_d_speed = {matrix["current_d_speed"]},
+            .d_angle_d_current = {matrix["angle_d_current"]},
+            .d_speed_d_current = {matrix["speed_d_current"]},
+            .d_current_d_current = {matrix["current_d_current"]},
+            .d_angle_d_voltage = {matrix["angle_d_voltage"]},
+            .d_speed_d_voltage = {matrix["speed_d_voltage"]},
+            .d_current_d_voltage = {matrix["current_d_voltage"]},
+            .d_angle_d_torque = {matrix["angle_d_torque"]},
+            .d_speed_d_torque = {matrix["speed_d_torque"]},
+            .d_current_d_torque = {matrix["current_d_torque"]},
             .d_voltage_d_torque = {round(PRESCALE_TORQUE / dv_dtau.subs(model).evalf())},
             .d_torque_d_voltage = {round(PRESCALE_VOLTAGE / dtau_dv.subs(model).evalf())},
             .d_torque_d_speed = {round(PRESCALE_SPEED / dtau_dw.subs(model).evalf())},
             .d_torque_d_acceleration = {round(PRESCALE_ACCELERATION / dtau_da.subs(model).evalf())},
             .torque_friction = {round(tau_s * c_tau)},
+            .d_angle_d_speed_reciprocal = {reciprocals["angle_d_speed"]},
+            .d_speed_d_speed_reciprocal = {reciprocals["speed_d_speed"]},
+            .d_current_d_speed_reciprocal = {reciprocals["current_d_speed"]},
+            .d_angle_d_current_reciprocal = {reciprocals["angle_d_current"]},
+            .d_speed_d_current_reciprocal = {reciprocals["speed_d_current"]},
+            .d_current_d_current_reciprocal = {reciprocals["current_d_current"]},
+            .d_angle_d_voltage_reciprocal = {reciprocals["angle_d_voltage"]},
+            .d_speed_d_voltage_reciprocal = {reciprocals["speed_d_voltage"]},
+            .d_current_d_voltage_reciprocal = {reciprocals["current_d_voltage"]},
+            .d_angle_d_torque_reciprocal = {reciprocals["angle_d_torque"]},
+            .d_speed_d_torque_reciprocal = {reciprocals["speed_d_torque"]},
+            .d_current_d_torque_reciprocal = {reciprocals["current_d_torque"]},
+        }};"""
+    )
+
+
+def make_simulation_model(name, *, h, **data):
+    """Initialize the floating point model for the motor simulation driver"""
+
+    model, tau_s = get_parameters(**data)
+    A, B = get_system_matrices(model, h)
+
+    return textwrap.dedent(
+        f"""
+        static const pbio_simulation_model_t model_{name} = {{
+            .d_angle_d_speed = {float(A[0, 1])!r},
+            .d_speed_d_speed = {float(A[1, 1])!r},
+            .d_current_d_speed = {float(A[2, 1])!r},
+            .d_angle_d_current = {float(A[0, 2])!r},
+            .d_speed_d_current = {float(A[1, 2])!r},
+            .d_current_d_current = {float(A[2, 2])!r},
+            .d_angle_d_voltage = {float(B[0, 0])!r},
+            .d_speed_d_voltage = {float(B[1, 0])!r},
+            .d_current_d_voltage = {float(B[2, 0])!r},
+            .d_angle_d_torque = {float(B[0, 1])!r},
+            .d_speed_d_torque = {float(B[1, 1])!r},
+            .d_current_d_torque = {float(B[2, 1])!r},
+            .torque_friction = {round(float(tau_s * c_tau), 3)!r},
         }};"""
     )
 
@@ -5,6 +5,7 @@
 
 #if PBDRV_CONFIG_CLOCK_LINUX
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
 #include <unistd.h>
@@ -17,16 +18,39 @@
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <contiki.h>
 
+#include <pbdrv/clock.h>
+
 #define NSEC_PER_MSEC       1000000
+#define USEC_PER_MSEC       1000
 
 #define TIMER_SIGNAL        SIGRTMIN
 #define TIMER_INTERVAL      (1 * NSEC_PER_MSEC)
 
 static pthread_t main_thread;
 
+// Simulated time mode. Instead of following the system clock, time only
+// advances when the event loop has nothing left to do, during delays, and
+// every so many VM loop iterations. This makes programs run as fast as the
+// CPU allows, with the same sequence of ticks each run.
+static bool simulated;
+static uint64_t simulated_us;
+
+bool pbdrv_clock_is_simulated(void) {
+    return simulated;
+}
+
+void pbdrv_clock_simulated_advance_us(uint32_t us) {
+    if (!simulated) {
+        return;
+    }
+    simulated_us += us;
+    etimer_request_poll();
+}
+
 static void handle_signal(int sig) {
     // since signals can occur on any thread, we need to ensure
     // that we interrupt the main thread. This is needed, e.g.
@@ -45,6 +69,13 @@ void pbdrv_clock_init(void) {
 
     main_thread = pthread_self();
 
+    // In simulated time mode, the event loop ticks the clock instead.
+    const char *simulated_env = getenv("PBIO_VIRTUAL_SIMULATED_TIME");
+    simulated = simulated_env && simulated_env[0];
+    if (simulated) {
+        return;
+    }
+
     // set up 1ms tick using signal
 
     struct sigaction sa = {
@@ -92,18 +123,33 @@ void pbdrv_clock_init(void) {
 #endif // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
 
 uint32_t pbdrv_clock_get_ms(void) {
+    #if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+    if (simulated) {
+        return simulated_us / 1000;
+    }
+    #endif
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 1000 + time_val.tv_nsec / 1000000;
 }
 
 uint32_t pbdrv_clock_get_100us(void) {
+    #if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+    if (simulated) {
+        return simulated_us / 100;
+    }
+    #endif
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 10000 + time_val.tv_nsec / 100000;
 }
 
 uint32_t pbdrv_clock_get_us(void) {
+    #if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+    if (simulated) {
+        return simulated_us;
+    }
+    #endif
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
     return time_val.tv_sec * 1000000 + time_val.tv_nsec / 1000;
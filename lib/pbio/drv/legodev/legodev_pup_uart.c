@@ -158,8 +158,6 @@ typedef struct {
 struct _pbdrv_legodev_pup_uart_dev_t {
     /** Main protothread, first used for synchronization thread and then for data send thread. */
     struct pt pt;
-    /** Protothread for receiving sensor data, running in parallel to the data send thread. */
-    struct pt recv_pt;
     /** Child protothread of the main protothread used for writing data */
     struct pt write_pt;
     /** Timer for sending keepalive messages and other delays. */
@@ -195,6 +193,8 @@ struct _pbdrv_legodev_pup_uart_dev_t {
     uint8_t *rx_msg;
     /** Size of the current message being received. */
     uint8_t rx_msg_size;
+    /** Number of bytes in the receive buffer while receiving data messages. */
+    uint8_t rx_msg_pos;
     /** Total number of errors that have occurred. */
     uint32_t err_count;
     /** Number of bad reads when receiving DATA ludev->msgs. */
@@ -205,6 +205,16 @@ struct _pbdrv_legodev_pup_uart_dev_t {
     bool data_rec;
     /** Return value for synchronization thread. */
     pbio_error_t err;
+    #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+    /** Most recent data samples, used as a ring buffer. */
+    pbdrv_legodev_sample_t *samples;
+    /** Total number of data samples received. */
+    uint32_t sample_count;
+    /** Value of sample_count when the current device was synchronized. */
+    uint32_t sample_first;
+    #endif
+    /** Legodev that was found not ready, to be notified when it is ready. */
+    pbdrv_legodev_dev_t *notify_legodev;
     /** ludev->msg to be printed in case of an error. */
     DBG_ERR(const char *last_err);
     #if PBDRV_CONFIG_LEGODEV_MODE_INFO
@@ -228,6 +238,9 @@ static pbdrv_legodev_pup_uart_dev_t ludevs[PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_DEV
 // The following data is really just part of ludevs, but separate allocation reduces overal code size
 static uint8_t data_read_bufs[PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_DEV][PBDRV_LEGODEV_MAX_DATA_SIZE] __attribute__((aligned(4)));
 static pbdrv_legodev_pup_uart_data_set_t data_set_bufs[PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_DEV];
+#if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+static pbdrv_legodev_sample_t sample_bufs[PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_DEV][PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES];
+#endif
 
 #define PBIO_PT_WAIT_READY(pt, expr) PT_WAIT_UNTIL((pt), (expr) != PBIO_ERROR_AGAIN)
 
@@ -240,6 +253,9 @@ pbdrv_legodev_pup_uart_dev_t *pbdrv_legodev_pup_uart_configure(uint8_t device_in
     ludev->err_count = 0;
     ludev->data_set = &data_set_bufs[device_index];
     ludev->bin_data = data_read_bufs[device_index];
+    #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+    ludev->samples = sample_bufs[device_index];
+    #endif
 
     // legodev driver is started after all other drivers, so we
     // assume that we do not need to wait for this to be ready.
@@ -284,6 +300,35 @@ static uint8_t ev3_uart_get_msg_size(uint8_t header) {
     return size;
 }
 
+/**
+ * Checks if the message in the receive buffer has a valid checksum.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ * @param [in]  msg_size    Size of the message, including header and checksum.
+ * @return                  True if the checksum is valid, false if not.
+ */
+static bool pbdrv_legodev_pup_uart_checksum_is_valid(pbdrv_legodev_pup_uart_dev_t *ludev, uint8_t msg_size) {
+    uint8_t checksum = 0xFF;
+    for (int i = 0; i < msg_size - 1; i++) {
+        checksum ^= ludev->rx_msg[i];
+    }
+    return checksum == ludev->rx_msg[msg_size - 1];
+}
+
+/**
+ * Checks if a bad checksum of the data message in the receive buffer is known
+ * to be harmless, so that the data can be used anyway.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ * @return                  True if the bad checksum can be ignored.
+ */
+static bool pbdrv_legodev_pup_uart_ignore_bad_checksum(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    // The LEGO EV3 color sensor sends bad checksums
+    // for RGB-RAW data (mode 4). The check here could be
+    // improved if someone can find a pattern.
+    return ludev->device_info.type_id == PBDRV_LEGODEV_TYPE_ID_EV3_COLOR_SENSOR
+           && ludev->rx_msg[0] == (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4);
+}
 
 static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev) {
     uint32_t speed;
@@ -306,27 +351,16 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
         mode += ludev->ext_mode;
     }
 
-    if (msg_size > 1) {
-        uint8_t checksum = 0xFF;
-        for (int i = 0; i < msg_size - 1; i++) {
-            checksum ^= ludev->rx_msg[i];
-        }
-        if (checksum != ludev->rx_msg[msg_size - 1]) {
-            DBG_ERR(ludev->last_err = "Bad checksum");
-            // if INFO messages are done and we are now receiving data, it is
-            // OK to occasionally have a bad checksum
-            if (ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_DATA) {
-
-                // The LEGO EV3 color sensor sends bad checksums
-                // for RGB-RAW data (mode 4). The check here could be
-                // improved if someone can find a pattern.
-                if (ludev->device_info.type_id != PBDRV_LEGODEV_TYPE_ID_EV3_COLOR_SENSOR
-                    || ludev->rx_msg[0] != (LUMP_MSG_TYPE_DATA | LUMP_MSG_SIZE_8 | 4)) {
-                    return;
-                }
-            } else {
-                goto err;
+    if (msg_size > 1 && !pbdrv_legodev_pup_uart_checksum_is_valid(ludev, msg_size)) {
+        DBG_ERR(ludev->last_err = "Bad checksum");
+        // if INFO messages are done and we are now receiving data, it is
+        // OK to occasionally have a bad checksum
+        if (ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_DATA) {
+            if (!pbdrv_legodev_pup_uart_ignore_bad_checksum(ludev)) {
+                return;
             }
+        } else {
+            goto err;
         }
     }
 
@@ -616,6 +650,17 @@ static void pbdrv_legodev_pup_uart_parse_msg(pbdrv_legodev_pup_uart_dev_t *ludev
             }
             ludev->device_info.mode = mode;
 
+            #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+            // Keep a history of all data, including for other modes. The
+            // UART drivers don't timestamp received bytes, so this uses the
+            // time of parsing. A burst of messages shares one timestamp.
+            pbdrv_legodev_sample_t *sample = &ludev->samples[ludev->sample_count % PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES];
+            memcpy(sample->data, ludev->rx_msg + 1, msg_size - 2);
+            sample->time = pbdrv_clock_get_ms();
+            sample->mode = mode;
+            ludev->sample_count++;
+            #endif
+
             ludev->data_rec = true;
             if (ludev->num_data_err) {
                 ludev->num_data_err--;
@@ -687,11 +732,26 @@ static void ev3_uart_prepare_tx_msg(pbdrv_legodev_pup_uart_dev_t *ludev, lump_ms
     ludev->tx_msg_size = offset + i + 2;
 }
 
+/**
+ * Posts a ready event if the device was found not ready before and it is now
+ * ready, or if it is no longer available.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_notify_ready(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    pbdrv_legodev_dev_t *legodev = ludev->notify_legodev;
+    if (legodev && pbdrv_legodev_is_ready(legodev) != PBIO_ERROR_AGAIN) {
+        ludev->notify_legodev = NULL;
+        pbio_event_post_ready(legodev);
+    }
+}
+
 static void pbdrv_legodev_pup_uart_reset(pbdrv_legodev_pup_uart_dev_t *ludev) {
     ludev->status = PBDRV_LEGODEV_PUP_UART_STATUS_ERR;
     if (ludev->dcmotor != NULL && ludev->dcmotor->motor_driver != NULL) {
         pbdrv_motor_driver_coast(ludev->dcmotor->motor_driver);
     }
+    pbdrv_legodev_pup_uart_notify_ready(ludev);
 }
 
 static PT_THREAD(pbdrv_legodev_pup_uart_send_prepared_msg(pbdrv_legodev_pup_uart_dev_t * ludev, pbio_error_t * err)) {
@@ -816,6 +876,10 @@ sync:
     ludev->data_rec = false;
     ludev->num_data_err = 0;
     ludev->status = PBDRV_LEGODEV_PUP_UART_STATUS_INFO;
+    #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+    // Samples from a previously attached device are no longer valid.
+    ludev->sample_first = ludev->sample_count;
+    #endif
     #if PBDRV_CONFIG_LEGODEV_MODE_INFO
     ludev->device_info.flags = PBDRV_LEGODEV_CAPABILITY_FLAG_NONE;
     ludev->info_flags = EV3_UART_INFO_FLAG_CMD_TYPE;
@@ -994,36 +1058,34 @@ static PT_THREAD(pbdrv_legodev_pup_uart_send_thread(pbdrv_legodev_pup_uart_dev_t
 }
 
 /**
- * The receive thread for the LEGO UART device.
+ * Drops bytes from the start of the receive buffer.
  *
  * @param [in]  ludev       The LEGO UART device instance.
+ * @param [in]  size        Number of bytes to drop.
  */
-static PT_THREAD(pbdrv_legodev_pup_uart_receive_data_thread(pbdrv_legodev_pup_uart_dev_t * ludev)) {
-
-    // REVISIT: This is not the greatest. We can easily get a buffer overrun and
-    // loose data. For now, the retry after bad message size helps get back into
-    // sync with the data stream.
-
-    pbio_error_t err;
+static void pbdrv_legodev_pup_uart_drop_rx_bytes(pbdrv_legodev_pup_uart_dev_t *ludev, uint8_t size) {
+    ludev->rx_msg_pos -= size;
+    memmove(ludev->rx_msg, ludev->rx_msg + size, ludev->rx_msg_pos);
+}
 
-    PT_BEGIN(&ludev->recv_pt);
+/**
+ * Parses all complete data messages at the start of the receive buffer.
+ *
+ * Bytes that cannot be the start of a valid message are dropped one at a
+ * time, so that the parser gets back into sync with the data stream after
+ * lost or corrupted bytes. An incomplete message is kept at the start of the
+ * buffer until the rest of it is received.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_parse_rx_bytes(pbdrv_legodev_pup_uart_dev_t *ludev) {
 
-    while (true) {
-        PBIO_PT_WAIT_READY(&ludev->recv_pt,
-            err = pbdrv_uart_read_begin(ludev->uart, ludev->rx_msg, 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data header begin error");
-            break;
-        }
-        PBIO_PT_WAIT_READY(&ludev->recv_pt, err = pbdrv_uart_read_end(ludev->uart));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data header end error");
-            break;
-        }
+    while (ludev->rx_msg_pos > 0) {
 
-        ludev->rx_msg_size = ev3_uart_get_msg_size(ludev->rx_msg[0]);
-        if (ludev->rx_msg_size < 3 || ludev->rx_msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
+        uint8_t msg_size = ev3_uart_get_msg_size(ludev->rx_msg[0]);
+        if (msg_size < 3 || msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
             DBG_ERR(ludev->last_err = "Bad data message size");
+            pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, 1);
             continue;
         }
 
@@ -1032,26 +1094,47 @@ static PT_THREAD(pbdrv_legodev_pup_uart_receive_data_thread(pbdrv_legodev_pup_ua
         if (msg_type != LUMP_MSG_TYPE_DATA && (msg_type != LUMP_MSG_TYPE_CMD ||
                                                (cmd != LUMP_CMD_WRITE && cmd != LUMP_CMD_EXT_MODE))) {
             DBG_ERR(ludev->last_err = "Bad msg type");
+            pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, 1);
             continue;
         }
 
-        PBIO_PT_WAIT_READY(&ludev->recv_pt,
-            err = pbdrv_uart_read_begin(ludev->uart, ludev->rx_msg + 1, ludev->rx_msg_size - 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data begin error");
-            break;
+        // Wait for the rest of the message.
+        if (ludev->rx_msg_pos < msg_size) {
+            return;
         }
-        PBIO_PT_WAIT_READY(&ludev->recv_pt, err = pbdrv_uart_read_end(ludev->uart));
-        if (err != PBIO_SUCCESS) {
-            DBG_ERR(ludev->last_err = "UART Rx data end error");
-            break;
+
+        // A bad checksum means that this was not really the start of a
+        // message, or that it was corrupted. Either way, resync from the
+        // next byte.
+        if (!pbdrv_legodev_pup_uart_checksum_is_valid(ludev, msg_size) &&
+            !pbdrv_legodev_pup_uart_ignore_bad_checksum(ludev)) {
+            DBG_ERR(ludev->last_err = "Bad checksum");
+            pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, 1);
+            continue;
         }
 
         // at this point, we have a full ludev->msg that can be parsed
         pbdrv_legodev_pup_uart_parse_msg(ludev);
+        pbdrv_legodev_pup_uart_drop_rx_bytes(ludev, msg_size);
     }
+}
 
-    PT_END(&ludev->recv_pt);
+/**
+ * Receives and parses sensor data for the LEGO UART device.
+ *
+ * This reads everything that the UART has received so far, so all messages
+ * that arrived since the last call are handled at once. It does not wait for
+ * data, so it can be called on every wakeup of the data send thread.
+ *
+ * @param [in]  ludev       The LEGO UART device instance.
+ */
+static void pbdrv_legodev_pup_uart_receive_data(pbdrv_legodev_pup_uart_dev_t *ludev) {
+    uint8_t size;
+    while ((size = pbdrv_uart_read_available(ludev->uart, ludev->rx_msg + ludev->rx_msg_pos,
+        EV3_UART_MAX_MESSAGE_SIZE - ludev->rx_msg_pos)) > 0) {
+        ludev->rx_msg_pos += size;
+        pbdrv_legodev_pup_uart_parse_rx_bytes(ludev);
+    }
 }
 
 /**
@@ -1074,12 +1157,13 @@ PT_THREAD(pbdrv_legodev_pup_uart_thread(struct pt *pt, pbdrv_legodev_pup_uart_de
         PT_EXIT(pt);
     }
 
-    // The sensor is now ready for use. Now run the send and receive threads in
-    // parallel until the send thread ends or exits.
+    // The sensor is now ready for use. Now run the send thread and receive
+    // any incoming data on each wakeup until the send thread ends or exits.
     PT_INIT(&ludev->pt);
-    PT_INIT(&ludev->recv_pt);
+    ludev->rx_msg_pos = 0;
     while (PT_SCHEDULE(pbdrv_legodev_pup_uart_send_thread(ludev))) {
-        pbdrv_legodev_pup_uart_receive_data_thread(ludev);
+        pbdrv_legodev_pup_uart_receive_data(ludev);
+        pbdrv_legodev_pup_uart_notify_ready(ludev);
         PT_YIELD(pt);
     }
     pbdrv_legodev_pup_uart_reset(ludev);
@@ -1106,19 +1190,14 @@ size_t pbdrv_legodev_size_of(pbdrv_legodev_data_type_t type) {
 }
 
 /**
- * Checks if LEGO UART device has data available for reading or is ready to write.
+ * Checks if an attached LEGO UART device has data available for reading or is
+ * ready to write.
  *
- * @param [in]  legodev     The legodev instance.
+ * @param [in]  ludev       The LEGO UART device instance.
  * @return                  ::PBIO_SUCCESS if ready.
  *                          ::PBIO_ERROR_AGAIN if not ready yet.
- *                          ::PBIO_ERROR_NO_DEV if no device is attached.
  */
-pbio_error_t pbdrv_legodev_is_ready(pbdrv_legodev_dev_t *legodev) {
-
-    pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
-    if (!ludev || ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_ERR) {
-        return PBIO_ERROR_NO_DEV;
-    }
+static pbio_error_t pbdrv_legodev_pup_uart_is_ready(pbdrv_legodev_pup_uart_dev_t *ludev) {
 
     if (ludev->status != PBDRV_LEGODEV_PUP_UART_STATUS_DATA) {
         return PBIO_ERROR_AGAIN;
@@ -1144,6 +1223,30 @@ pbio_error_t pbdrv_legodev_is_ready(pbdrv_legodev_dev_t *legodev) {
     return PBIO_SUCCESS;
 }
 
+/**
+ * Checks if LEGO UART device has data available for reading or is ready to write.
+ *
+ * If it is not ready yet, a ready event for @p legodev is posted once it is.
+ *
+ * @param [in]  legodev     The legodev instance.
+ * @return                  ::PBIO_SUCCESS if ready.
+ *                          ::PBIO_ERROR_AGAIN if not ready yet.
+ *                          ::PBIO_ERROR_NO_DEV if no device is attached.
+ */
+pbio_error_t pbdrv_legodev_is_ready(pbdrv_legodev_dev_t *legodev) {
+
+    pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
+    if (!ludev || ludev->status == PBDRV_LEGODEV_PUP_UART_STATUS_ERR) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    pbio_error_t err = pbdrv_legodev_pup_uart_is_ready(ludev);
+    if (err == PBIO_ERROR_AGAIN) {
+        ludev->notify_legodev = legodev;
+    }
+    return err;
+}
+
 /**
  * Starts setting the mode of a LEGO UART device.
  *
@@ -1214,6 +1317,33 @@ pbio_error_t pbdrv_legodev_get_data(pbdrv_legodev_dev_t *legodev, uint8_t mode,
     return pbdrv_legodev_is_ready(legodev);
 }
 
+#if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
+pbio_error_t pbdrv_legodev_get_next_sample(pbdrv_legodev_dev_t *legodev, uint32_t *cursor, const pbdrv_legodev_sample_t **sample) {
+
+    pbdrv_legodev_pup_uart_dev_t *ludev = pbdrv_legodev_get_uart_dev(legodev);
+    if (!ludev) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    // Skip samples that have been overwritten or are from a previous device.
+    uint32_t oldest = ludev->sample_count - ludev->sample_first > PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES ?
+        ludev->sample_count - PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES : ludev->sample_first;
+    if (*cursor - oldest > ludev->sample_count - oldest) {
+        *cursor = oldest;
+    }
+
+    if (*cursor == ludev->sample_count) {
+        return PBIO_ERROR_AGAIN;
+    }
+
+    *sample = &ludev->samples[*cursor % PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES];
+    (*cursor)++;
+    return PBIO_SUCCESS;
+}
+
+#endif // PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
 /**
  * Set data for the current mode.
  *
@@ -5,6 +5,8 @@
 
 #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION
 
+#include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -19,6 +21,7 @@
 
 #include <pbio/battery.h>
 #include <pbio/observer.h>
+#include <pbio/util.h>
 
 #include "motor_driver_virtual_simulation.h"
 
@@ -48,6 +51,23 @@ struct _pbdrv_motor_driver_dev_t {
     const pbdrv_motor_driver_virtual_simulation_platform_data_t *pdata;
 };
 
+// Model settings auto-generated by pbio/doc/control/motor_data.py --simulation
+static const pbio_simulation_model_t model_technic_s_angular = {
+    .d_angle_d_speed = 0.0009970293444820685,
+    .d_speed_d_speed = 0.9915834369366789,
+    .d_current_d_speed = -0.001974021572761015,
+    .d_angle_d_current = 0.0030080026320155845,
+    .d_speed_d_current = 5.35441521072031,
+    .d_current_d_current = 0.4726397796787567,
+    .d_angle_d_voltage = 0.00044236879261772314,
+    .d_speed_d_voltage = 1.2533344300064932,
+    .d_current_d_voltage = 0.293957187049306,
+    .d_angle_d_torque = -0.00020632116607675432,
+    .d_speed_d_torque = -0.41204989708270917,
+    .d_current_d_torque = 0.00045831062970591775,
+    .torque_friction = 9182.16,
+};
+
 static const pbio_simulation_model_t model_technic_m_angular = {
     .d_angle_d_speed = 0.0009981527613056019,
     .d_speed_d_speed = 0.994653578576391,
@@ -64,8 +84,152 @@ static const pbio_simulation_model_t model_technic_m_angular = {
     .torque_friction = 21413.268,
 };
 
+static const pbio_simulation_model_t model_technic_l_angular = {
+    .d_angle_d_speed = 0.0009989905838264116,
+    .d_speed_d_speed = 0.9970472644002997,
+    .d_current_d_speed = -0.005135634057919127,
+    .d_angle_d_current = 0.0004936363097546974,
+    .d_speed_d_current = 0.9381983530548226,
+    .d_current_d_current = 0.7301692153525317,
+    .d_angle_d_voltage = 0.0001406279188998589,
+    .d_speed_d_voltage = 0.4113635914622477,
+    .d_current_d_voltage = 0.7154764790710809,
+    .d_angle_d_torque = -2.3498719339090655e-05,
+    .d_speed_d_torque = -0.0469740684094062,
+    .d_current_d_torque = 0.00012705837079320106,
+    .torque_friction = 23239.206,
+};
+
+static const pbio_simulation_model_t model_interactive = {
+    .d_angle_d_speed = 0.000994637546494511,
+    .d_speed_d_speed = 0.9865845226395328,
+    .d_current_d_speed = -0.0027906550571618594,
+    .d_angle_d_current = 0.0014924133324574478,
+    .d_speed_d_current = 2.059032680086662,
+    .d_current_d_current = 0.0426314026331055,
+    .d_angle_d_voltage = 0.0009942492653868388,
+    .d_speed_d_voltage = 2.487355554095746,
+    .d_current_d_voltage = 0.5174136685178088,
+    .d_angle_d_torque = -0.00012074442235607962,
+    .d_speed_d_torque = -0.24091566870109257,
+    .d_current_d_torque = 0.0004899279722327494,
+    .torque_friction = 11226.846,
+};
+
+static const pbio_simulation_model_t model_technic_l = {
+    .d_angle_d_speed = 0.0009981849631106577,
+    .d_speed_d_speed = 0.994891913338067,
+    .d_current_d_speed = -0.003219915754588595,
+    .d_angle_d_current = 0.0010730046842056403,
+    .d_speed_d_current = 1.8841889023533096,
+    .d_current_d_current = 0.42979669840776846,
+    .d_angle_d_voltage = 0.00042362960997255567,
+    .d_speed_d_voltage = 1.1922274268951558,
+    .d_current_d_voltage = 0.7515283371209779,
+    .d_angle_d_torque = -6.318018879842275e-05,
+    .d_speed_d_torque = -0.1262500845186173,
+    .d_current_d_torque = 0.00023192220939537725,
+    .torque_friction = 26430.0,
+};
+
+static const pbio_simulation_model_t model_technic_xl = {
+    .d_angle_d_speed = 0.000997448188034343,
+    .d_speed_d_speed = 0.9930686404440283,
+    .d_current_d_speed = -0.00386452952641891,
+    .d_angle_d_current = 0.0009684968932744069,
+    .d_speed_d_current = 1.5804247531908615,
+    .d_current_d_current = 0.24655464412115602,
+    .d_angle_d_voltage = 0.000594260991416856,
+    .d_speed_d_voltage = 1.614161488790678,
+    .d_current_d_voltage = 0.8999640955670182,
+    .d_angle_d_torque = -6.801217184137625e-05,
+    .d_speed_d_torque = -0.1358612741931,
+    .d_current_d_torque = 0.0003225717841031151,
+    .torque_friction = 12892.683,
+};
+
+static const pbio_simulation_model_t model_movehub = {
+    .d_angle_d_speed = 0.000997579554386179,
+    .d_speed_d_speed = 0.9934297959224667,
+    .d_current_d_speed = -0.003340798894006241,
+    .d_angle_d_current = 0.0010574029310172729,
+    .d_speed_d_current = 1.7232004893339468,
+    .d_current_d_current = 0.24392882665845794,
+    .d_angle_d_voltage = 0.0006492406872549984,
+    .d_speed_d_voltage = 1.7623382183621212,
+    .d_current_d_voltage = 0.8961087815980798,
+    .d_angle_d_torque = -9.022001661939328e-05,
+    .d_speed_d_torque = -0.18023496150674656,
+    .d_current_d_torque = 0.00037037915142957336,
+    .torque_friction = 24834.783,
+};
+
+static const pbio_simulation_model_t model_ev3_l = {
+    .d_angle_d_speed = 0.0009994673399243267,
+    .d_speed_d_speed = 0.998448457316151,
+    .d_current_d_speed = -0.004604891879560636,
+    .d_angle_d_current = 0.0002818635875659014,
+    .d_speed_d_current = 0.5311462591239253,
+    .d_current_d_current = 0.691455665345442,
+    .d_angle_d_voltage = 6.451105360931212e-05,
+    .d_speed_d_voltage = 0.1879090583772676,
+    .d_current_d_voltage = 0.5577035720801213,
+    .d_angle_d_torque = -1.1557559730912891e-05,
+    .d_speed_d_torque = -0.023109071443337036,
+    .d_current_d_torque = 5.6501265365599354e-05,
+    .torque_friction = 16476.19,
+};
+
+static const pbio_simulation_model_t model_ev3_m = {
+    .d_angle_d_speed = 0.0009987540438725069,
+    .d_speed_d_speed = 0.9964562640456468,
+    .d_current_d_speed = -0.0025238477763320317,
+    .d_angle_d_current = 0.00101424166969418,
+    .d_speed_d_current = 1.820226810242209,
+    .d_current_d_current = 0.5003896321459029,
+    .d_angle_d_voltage = 0.00023773415765961195,
+    .d_speed_d_voltage = 0.6761611131294533,
+    .d_current_d_voltage = 0.4815617596219738,
+    .d_angle_d_torque = -5.499240715036469e-05,
+    .d_speed_d_torque = -0.10991848258559798,
+    .d_current_d_torque = 0.00015477160041601617,
+    .torque_friction = 18317.241,
+};
+
+static const struct {
+    pbdrv_legodev_type_id_t id;
+    const pbio_simulation_model_t *model;
+} models[] = {
+    { .id = PBDRV_LEGODEV_TYPE_ID_EV3_MEDIUM_MOTOR, .model = &model_ev3_m },
+    { .id = PBDRV_LEGODEV_TYPE_ID_EV3_LARGE_MOTOR, .model = &model_ev3_l },
+    { .id = PBDRV_LEGODEV_TYPE_ID_MOVE_HUB_MOTOR, .model = &model_movehub },
+    { .id = PBDRV_LEGODEV_TYPE_ID_INTERACTIVE_MOTOR, .model = &model_interactive },
+    { .id = PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_MOTOR, .model = &model_technic_l },
+    { .id = PBDRV_LEGODEV_TYPE_ID_TECHNIC_XL_MOTOR, .model = &model_technic_xl },
+    { .id = PBDRV_LEGODEV_TYPE_ID_SPIKE_S_MOTOR, .model = &model_technic_s_angular },
+    { .id = PBDRV_LEGODEV_TYPE_ID_SPIKE_M_MOTOR, .model = &model_technic_m_angular },
+    { .id = PBDRV_LEGODEV_TYPE_ID_SPIKE_L_MOTOR, .model = &model_technic_l_angular },
+    { .id = PBDRV_LEGODEV_TYPE_ID_TECHNIC_M_ANGULAR_MOTOR, .model = &model_technic_m_angular },
+    { .id = PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_ANGULAR_MOTOR, .model = &model_technic_l_angular },
+};
+
 static pbdrv_motor_driver_dev_t motor_driver_devs[PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV];
 
+/**
+ * Gets the simulation model of a motor.
+ *
+ * @param [in]  id          The device type ID of the motor.
+ * @return                  The model or NULL if there is no model for this ID.
+ */
+static const pbio_simulation_model_t *pbdrv_motor_driver_virtual_simulation_get_model(pbdrv_legodev_type_id_t id) {
+    for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(models); i++) {
+        if (models[i].id == id) {
+            return models[i].model;
+        }
+    }
+    return NULL;
+}
+
 pbio_error_t pbdrv_motor_driver_get_dev(uint8_t id, pbdrv_motor_driver_dev_t **driver) {
     if (id >= PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV) {
         return PBIO_ERROR_INVALID_ARG;
@@ -86,6 +250,165 @@ pbio_error_t pbdrv_motor_driver_set_duty_cycle(pbdrv_motor_driver_dev_t *driver,
     return PBIO_SUCCESS;
 }
 
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
+// Simulation time step (s).
+#define TIME_STEP (0.001)
+
+// Gravitational acceleration (m/s^2).
+#define GRAVITY (9.81)
+
+/**
+ * State of the simulated robot body. Heading and rate are positive clockwise
+ * and y is positive to the right, matching the drive base conventions.
+ */
+typedef struct {
+    /** Position in the forward direction at the start (mm). */
+    double x;
+    /** Position to the right of the start (mm). */
+    double y;
+    /** Heading (rad). */
+    double heading;
+    /** Forward speed (mm/s). */
+    double speed;
+    /** Turn rate (rad/s). */
+    double rate;
+    /** Left wheel motor, or NULL if the body is not simulated. */
+    pbdrv_motor_driver_dev_t *left;
+    /** Right wheel motor. */
+    pbdrv_motor_driver_dev_t *right;
+} pbdrv_motor_driver_virtual_simulation_drivebase_t;
+
+static pbdrv_motor_driver_virtual_simulation_drivebase_t drivebase;
+
+// Whether the wheel motors drive the simulated body. Otherwise, they run
+// without load like all other motors.
+static bool drivebase_attached;
+
+/**
+ * Gets the speed of the wheel surface in the forward direction.
+ *
+ * @param [in]  driver      The motor driving the wheel.
+ * @param [in]  direction   Direction in which the motor turns to drive forward.
+ * @return                  The speed (mm/s).
+ */
+static double pbdrv_motor_driver_virtual_simulation_get_wheel_speed(const pbdrv_motor_driver_dev_t *driver, pbio_direction_t direction) {
+    double radius = pbdrv_motor_driver_virtual_simulation_drivebase_platform_data.wheel_diameter / 2;
+    double speed = driver->speed * M_PI / 180000 * radius;
+    return direction == PBIO_DIRECTION_CLOCKWISE ? speed : -speed;
+}
+
+/**
+ * Applies a load torque to a motor for the current time step, on top of the
+ * state it already reached in this step.
+ *
+ * @param [in]  driver      The motor.
+ * @param [in]  torque      The load torque (uNm).
+ */
+static void pbdrv_motor_driver_virtual_simulation_apply_torque(pbdrv_motor_driver_dev_t *driver, double torque) {
+    const pbio_simulation_model_t *m = driver->model;
+    driver->angle += torque * m->d_angle_d_torque;
+    driver->speed += torque * m->d_speed_d_torque;
+    driver->current += torque * m->d_current_d_torque;
+    driver->torque = torque;
+}
+
+/**
+ * Resets the simulated robot body to the origin, standing still.
+ */
+static void pbdrv_motor_driver_virtual_simulation_drivebase_init(void) {
+    const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t *pdata = &pbdrv_motor_driver_virtual_simulation_drivebase_platform_data;
+    pbdrv_motor_driver_virtual_simulation_drivebase_t *db = &drivebase;
+
+    *db = (pbdrv_motor_driver_virtual_simulation_drivebase_t) { 0 };
+
+    // The body is only simulated if both wheels have a motor.
+    if (drivebase_attached && motor_driver_devs[pdata->left_index].model && motor_driver_devs[pdata->right_index].model) {
+        db->left = &motor_driver_devs[pdata->left_index];
+        db->right = &motor_driver_devs[pdata->right_index];
+    }
+}
+
+/**
+ * Applies the ground contact forces to the wheels and moves the robot body.
+ *
+ * This runs after the motors were updated for this time step. The traction
+ * forces are chosen such that the wheels roll without slipping at the end of
+ * the step, but are limited by the friction with the ground. If a wheel needs
+ * more than that, it slips.
+ */
+static void pbdrv_motor_driver_virtual_simulation_drivebase_update(void) {
+    const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t *pdata = &pbdrv_motor_driver_virtual_simulation_drivebase_platform_data;
+    pbdrv_motor_driver_virtual_simulation_drivebase_t *db = &drivebase;
+
+    if (!db->left) {
+        return;
+    }
+
+    double radius = pdata->wheel_diameter / 2;
+    double half_track = pdata->axle_track / 2;
+
+    // Slip speed of each wheel with respect to the ground (mm/s).
+    double slip_left = pbdrv_motor_driver_virtual_simulation_get_wheel_speed(db->left, pdata->left_direction) -
+        (db->speed + db->rate * half_track);
+    double slip_right = pbdrv_motor_driver_virtual_simulation_get_wheel_speed(db->right, pdata->right_direction) -
+        (db->speed - db->rate * half_track);
+
+    // Change of slip speed per Newton of traction in one step, from slowing
+    // down the wheel, accelerating the body, and turning the body.
+    double k_left = -db->left->model->d_speed_d_torque * radius * 1000 * M_PI / 180000 * radius;
+    double k_right = -db->right->model->d_speed_d_torque * radius * 1000 * M_PI / 180000 * radius;
+    double k_speed = TIME_STEP * 1000 / pdata->mass;
+    double k_rate = TIME_STEP * half_track * half_track / 1000 / pdata->inertia;
+
+    // Solve for the forces that make both slip speeds zero.
+    double a_left = k_left + k_speed + k_rate;
+    double a_right = k_right + k_speed + k_rate;
+    double d = k_speed - k_rate;
+    double det = a_left * a_right - d * d;
+    double force_left = (a_right * slip_left - d * slip_right) / det;
+    double force_right = (a_left * slip_right - d * slip_left) / det;
+
+    // If a wheel needs more than the available friction, it slips, so solve
+    // again for the other wheel given the friction force of the slipping one.
+    double force_max = pdata->friction_coefficient * pdata->mass * GRAVITY / 2;
+    if (fabs(force_left) > force_max) {
+        force_left = copysign(force_max, force_left);
+        force_right = fmax(-force_max, fmin(force_max, (slip_right - d * force_left) / a_right));
+    } else if (fabs(force_right) > force_max) {
+        force_right = copysign(force_max, force_right);
+        force_left = fmax(-force_max, fmin(force_max, (slip_left - d * force_right) / a_left));
+    }
+
+    // The ground pushes back on the wheels (N mm to uNm).
+    pbdrv_motor_driver_virtual_simulation_apply_torque(db->left,
+        (pdata->left_direction == PBIO_DIRECTION_CLOCKWISE ? 1000 : -1000) * force_left * radius);
+    pbdrv_motor_driver_virtual_simulation_apply_torque(db->right,
+        (pdata->right_direction == PBIO_DIRECTION_CLOCKWISE ? 1000 : -1000) * force_right * radius);
+
+    // And forward on the body.
+    db->speed += k_speed * (force_left + force_right);
+    db->rate += TIME_STEP * half_track / 1000 * (force_left - force_right) / pdata->inertia;
+    db->heading += db->rate * TIME_STEP;
+    db->x += db->speed * cos(db->heading) * TIME_STEP;
+    db->y += db->speed * sin(db->heading) * TIME_STEP;
+}
+
+/**
+ * Gets the position of the simulated robot body.
+ *
+ * @param [out] x           Position in the forward direction at the start (mm).
+ * @param [out] y           Position to the right of the start (mm).
+ * @param [out] heading     Heading, positive clockwise (deg).
+ */
+void pbdrv_motor_driver_virtual_simulation_get_drivebase_state(int32_t *x, int32_t *y, int32_t *heading) {
+    *x = drivebase.x;
+    *y = drivebase.y;
+    *heading = drivebase.heading * 180 / M_PI;
+}
+
+#endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
 static pid_t data_parser_pid;
 static FILE *data_parser_in;
 
@@ -112,24 +435,16 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
         driver->voltage = 0;
 
         // Select model corresponding to device ID.
-        switch (driver->pdata->type_id) {
-            case PBDRV_LEGODEV_TYPE_ID_SPIKE_S_MOTOR:
-                driver->model = &model_technic_m_angular; // TODO
-                break;
-            case PBDRV_LEGODEV_TYPE_ID_SPIKE_M_MOTOR:
-                driver->model = &model_technic_m_angular;
-                break;
-            case PBDRV_LEGODEV_TYPE_ID_SPIKE_L_MOTOR:
-                driver->model = &model_technic_m_angular; // TODO
-                break;
-            case PBDRV_LEGODEV_TYPE_ID_NONE:
-                driver->model = NULL;
-                break;
-            default:
-                PROCESS_EXIT();
+        driver->model = pbdrv_motor_driver_virtual_simulation_get_model(driver->pdata->type_id);
+        if (!driver->model && driver->pdata->type_id != PBDRV_LEGODEV_TYPE_ID_NONE) {
+            PROCESS_EXIT();
         }
     }
 
+    #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+    pbdrv_motor_driver_virtual_simulation_drivebase_init();
+    #endif
+
     pbdrv_init_busy_down();
 
     etimer_set(&tick_timer, 1);
@@ -219,6 +534,10 @@ PROCESS_THREAD(pbdrv_motor_driver_virtual_simulation_process, ev, data) {
             driver->current = current_next;
         }
 
+        #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+        pbdrv_motor_driver_virtual_simulation_drivebase_update();
+        #endif
+
         etimer_reset(&tick_timer);
     }
 
@@ -278,6 +597,12 @@ static void pbdrv_motor_driver_start_simulation(void) {
 void pbdrv_motor_driver_init(void) {
     pbdrv_motor_driver_virtual_simulation_prepare_parser();
     #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_AUTO_START
+    #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+    // The wheel motors only drive the body if requested, so that the motors
+    // on these ports can otherwise be used on their own.
+    const char *drivebase_env = getenv("PBIO_VIRTUAL_DRIVEBASE");
+    drivebase_attached = drivebase_env && drivebase_env[0];
+    #endif
     pbdrv_motor_driver_start_simulation();
     #endif
 }
@@ -285,8 +610,19 @@ void pbdrv_motor_driver_init(void) {
 #if !PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_AUTO_START
 void pbdrv_motor_driver_init_manual(void) {
     // Motor tests can start the simulation as needed.
+    #if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+    drivebase_attached = false;
+    #endif
+    pbdrv_motor_driver_start_simulation();
+}
+
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+void pbdrv_motor_driver_init_manual_drivebase(void) {
+    // Drive base tests can let the wheel motors drive the simulated body.
+    drivebase_attached = true;
     pbdrv_motor_driver_start_simulation();
 }
+#endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
 #endif // !PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_AUTO_START
 
 void pbdrv_motor_driver_virtual_simulation_get_angle(pbdrv_motor_driver_dev_t *dev, int32_t *rotations, int32_t *millidegrees) {
@@ -39,8 +39,47 @@ extern const pbdrv_motor_driver_virtual_simulation_platform_data_t
 
 void pbdrv_motor_driver_virtual_simulation_get_angle(pbdrv_motor_driver_dev_t *dev, int32_t *rotations, int32_t *millidegrees);
 
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
+/**
+ * Description of a simulated robot body with two driven wheels.
+ *
+ * The wheels slip when the traction force needed to keep them rolling
+ * exceeds the friction with the ground.
+ */
+typedef struct {
+    /** Index of the motor driver that drives the left wheel. */
+    uint8_t left_index;
+    /** Index of the motor driver that drives the right wheel. */
+    uint8_t right_index;
+    /** Direction in which the left motor turns to drive forward. */
+    pbio_direction_t left_direction;
+    /** Direction in which the right motor turns to drive forward. */
+    pbio_direction_t right_direction;
+    /** Wheel diameter (mm). */
+    double wheel_diameter;
+    /** Distance between the points where the wheels touch the ground (mm). */
+    double axle_track;
+    /** Mass of the robot, carried equally by both wheels (kg). */
+    double mass;
+    /** Moment of inertia about the vertical axis (kg m^2). */
+    double inertia;
+    /** Coefficient of friction between the wheels and the ground. */
+    double friction_coefficient;
+} pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t;
+
+extern const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t
+    pbdrv_motor_driver_virtual_simulation_drivebase_platform_data;
+
+void pbdrv_motor_driver_virtual_simulation_get_drivebase_state(int32_t *x, int32_t *y, int32_t *heading);
+
+#endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+
 #if !PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_AUTO_START
 void pbdrv_motor_driver_init_manual(void);
+#if PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION_DRIVEBASE
+void pbdrv_motor_driver_init_manual_drivebase(void);
+#endif
 #endif
 
 #endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION
@@ -110,6 +110,18 @@ pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart_dev) {
     return err;
 }
 
+uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint8_t size) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+
+    uint8_t count = 0;
+    while (count < size && uart->rx_ring_buf_head != uart->rx_ring_buf_tail) {
+        buf[count++] = uart->rx_ring_buf[uart->rx_ring_buf_tail];
+        uart->rx_ring_buf_tail = (uart->rx_ring_buf_tail + 1) & (UART_RING_BUF_SIZE - 1);
+    }
+
+    return count;
+}
+
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
 
@@ -231,6 +243,11 @@ static void handle_poll(void) {
             }
         }
 
+        // broadcast when there is new data for pbdrv_uart_read_available()
+        if (!uart->rx_buf && uart->rx_ring_buf_head != uart->rx_ring_buf_tail) {
+            process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
+        }
+
         if (uart->tx_buf && uart->tx_buf_index == uart->tx_buf_size) {
             // TODO: this should only be sent once per write_begin
             process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
@@ -106,6 +106,21 @@ pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart_dev) {
     return PBIO_SUCCESS;
 }
 
+uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint8_t size) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+
+    uint8_t count = 0;
+    while (count < size) {
+        int c = ringbuf_get(&uart->rx_buf);
+        if (c == -1) {
+            break;
+        }
+        buf[count++] = c;
+    }
+
+    return count;
+}
+
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     // TODO
 }
@@ -231,6 +246,11 @@ static void handle_poll(void) {
             process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
         }
 
+        // broadcast when there is new data for pbdrv_uart_read_available()
+        if (!uart->read_buf && ringbuf_elements(&uart->rx_buf)) {
+            process_post(PROCESS_BROADCAST, PROCESS_EVENT_COM, NULL);
+        }
+
         // broadcast when write_buf is drained
         if (uart->write_buf && uart->write_pos == uart->write_length) {
             // clearing write_buf to prevent multiple broadcasts
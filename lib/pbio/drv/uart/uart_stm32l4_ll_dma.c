@@ -237,6 +237,23 @@ pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart_dev) {
     return PBIO_SUCCESS;
 }
 
+uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart_dev, uint8_t *buf, uint8_t size) {
+    pbdrv_uart_t *uart = PBIO_CONTAINER_OF(uart_dev, pbdrv_uart_t, uart_dev);
+    const pbdrv_uart_stm32l4_ll_dma_platform_data_t *pdata = uart->pdata;
+
+    // head is the last position that DMA wrote to. It is RX_DATA_SIZE if
+    // the DMA counter just reloaded, which is the same as 0.
+    uint32_t rx_head = (RX_DATA_SIZE - LL_DMA_GetDataLength(pdata->rx_dma, pdata->rx_dma_ch)) & (RX_DATA_SIZE - 1);
+
+    uint8_t count = 0;
+    while (count < size && uart->rx_tail != rx_head) {
+        buf[count++] = uart->rx_data[uart->rx_tail];
+        uart->rx_tail = (uart->rx_tail + 1) & (RX_DATA_SIZE - 1);
+    }
+
+    return count;
+}
+
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart_dev) {
     // TODO
 }
@@ -9,8 +9,11 @@
 #ifndef _PBDRV_CLOCK_H_
 #define _PBDRV_CLOCK_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <pbdrv/config.h>
+
 /**
  * Gets the current clock time in milliseconds (1e-3 seconds).
  */
@@ -36,6 +39,40 @@ uint32_t pbdrv_clock_get_us(void);
  */
 void pbdrv_clock_delay_us(uint32_t us);
 
+#if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+
+/**
+ * Checks if the clock runs in simulated time mode.
+ *
+ * In this mode, time does not follow the system clock. It only advances when
+ * the event loop calls pbdrv_clock_simulated_advance_us(), so programs run as fast
+ * as the CPU allows and produce the same sequence of ticks on every run. It is
+ * enabled by setting the PBIO_VIRTUAL_SIMULATED_TIME environment variable.
+ *
+ * @return                  True if time is simulated, false otherwise.
+ */
+bool pbdrv_clock_is_simulated(void);
+
+/**
+ * Advances the simulated clock and polls etimers.
+ *
+ * Does nothing if the clock is not in simulated time mode.
+ *
+ * @param [in]  us          Time to advance the clock by (microseconds).
+ */
+void pbdrv_clock_simulated_advance_us(uint32_t us);
+
+#else // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+
+static inline bool pbdrv_clock_is_simulated(void) {
+    return false;
+}
+
+static inline void pbdrv_clock_simulated_advance_us(uint32_t us) {
+}
+
+#endif // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
+
 #endif /* _PBDRV_CLOCK_H_ */
 
 /** @} */
@@ -413,6 +413,22 @@ typedef enum {
  */
 #define PBDRV_LEGODEV_MAX_DATA_SIZE    LUMP_MAX_MSG_SIZE
 
+/**
+ * Data sample received from an I/O device.
+ */
+typedef struct {
+    /** Raw data, aligned at 4 bytes. Interpreted as for pbdrv_legodev_get_data(). */
+    uint8_t data[PBDRV_LEGODEV_MAX_DATA_SIZE] __attribute__((aligned(4)));
+    /**
+     * Time at which the message was parsed, in milliseconds. This is not the
+     * time of arrival of each byte. Messages that are read from the UART
+     * in the same wakeup all get the same time.
+     */
+    uint32_t time;
+    /** The mode of the data. */
+    uint8_t mode;
+} pbdrv_legodev_sample_t;
+
 /**
  * I/O device capability flags.
  */
@@ -636,6 +652,35 @@ static inline pbio_error_t pbdrv_legodev_get_data(pbdrv_legodev_dev_t *legodev,
 
 #endif // PBDRV_CONFIG_LEGODEV
 
+#if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
+/**
+ * Gets the next data sample received from the legodev device.
+ *
+ * Each device keeps the ::PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES most
+ * recent data samples. The cursor counts the samples that have been read, so
+ * calling this repeatedly with the same cursor gives all samples in the order
+ * they were received. Start with a cursor of 0 to get the oldest sample that
+ * is still available. If samples were overwritten before they were read, the
+ * cursor skips ahead by more than one.
+ *
+ * @param [in]  legodev   The legodev device instance.
+ * @param [in, out] cursor Number of samples read so far. Updated to include the returned sample.
+ * @param [out] sample    The sample.
+ * @return                ::PBIO_SUCCESS on success.
+ *                        ::PBIO_ERROR_AGAIN if there is no new sample yet.
+ *                        ::PBIO_ERROR_NO_DEV if no device is attached or does not support it.
+ */
+pbio_error_t pbdrv_legodev_get_next_sample(pbdrv_legodev_dev_t *legodev, uint32_t *cursor, const pbdrv_legodev_sample_t **sample);
+
+#else // PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
+static inline pbio_error_t pbdrv_legodev_get_next_sample(pbdrv_legodev_dev_t *legodev, uint32_t *cursor, const pbdrv_legodev_sample_t **sample) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+#endif // PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
 #endif // PBDRV_LEGODEV_H
 
 /** @} */
@@ -32,6 +32,18 @@ pbio_error_t pbdrv_uart_get(uint8_t id, pbdrv_uart_dev_t **uart_dev);
 void pbdrv_uart_set_baud_rate(pbdrv_uart_dev_t *uart, uint32_t baud);
 pbio_error_t pbdrv_uart_read_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout);
 pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart);
+/**
+ * Copies bytes that have already been received, without waiting for more.
+ *
+ * This must not be used while a read started with pbdrv_uart_read_begin()
+ * is in progress.
+ *
+ * @param [in]  uart    The UART device
+ * @param [out] buf     Buffer for the received bytes
+ * @param [in]  size    Size of @p buf in bytes
+ * @return              The number of bytes copied to @p buf
+ */
+uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint8_t size);
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart);
 pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout);
 pbio_error_t pbdrv_uart_write_end(pbdrv_uart_dev_t *uart);
@@ -52,6 +64,9 @@ static inline pbio_error_t pbdrv_uart_read_begin(pbdrv_uart_dev_t *uart, uint8_t
 static inline pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
+static inline uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint8_t size) {
+    return 0;
+}
 static inline void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart) {
 }
 static inline pbio_error_t pbdrv_uart_write_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t length, uint32_t timeout) {
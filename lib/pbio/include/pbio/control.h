@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <pbio/angle.h>
+#include <pbio/config.h>
 #include <pbio/control_settings.h>
 #include <pbio/error.h>
 #include <pbio/port.h>
@@ -28,6 +29,12 @@
 // Number of values per row when control data logger is active.
 #define PBIO_CONTROL_LOGGER_NUM_COLS (12)
 
+// Number of position targets that can be queued to run after the ongoing
+// maneuver. Set to 0 to disable the queue.
+#ifndef PBIO_CONFIG_CONTROL_QUEUE_SIZE
+#define PBIO_CONFIG_CONTROL_QUEUE_SIZE (0)
+#endif
+
 /**
  * Actions to be taken when a control command completes.
  */
@@ -125,6 +132,24 @@ typedef enum {
     PBIO_CONTROL_STATUS_COMPLETE = 1 << 1,
 } pbio_control_status_flag_t;
 
+/**
+ * Position target that runs when the preceding maneuver reaches its endpoint.
+ */
+typedef struct _pbio_control_segment_t {
+    /**
+     * Position to run to (control units).
+     */
+    pbio_angle_t target;
+    /**
+     * Top speed on the way to the target (control units).
+     */
+    int32_t speed;
+    /**
+     * Action to be taken if this is the last segment when it completes.
+     */
+    pbio_control_on_completion_t on_completion;
+} pbio_control_segment_t;
+
 /**
  * Controller status and state.
  */
@@ -163,10 +188,25 @@ typedef struct _pbio_control_t {
      * Slow moving average of the PID output, which is a measure for load.
      */
     int32_t pid_average;
+    /**
+     * Number of control loops since the previous controller update. This is
+     * 1 unless the owner of this controller updates it less frequently.
+     */
+    uint8_t update_interval;
     /**
      * Control state flags such as being on target and/or being stalled.
      */
     pbio_control_status_flag_t status;
+    #if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+    /**
+     * Position targets to run after the ongoing maneuver, in order.
+     */
+    pbio_control_segment_t queue[PBIO_CONFIG_CONTROL_QUEUE_SIZE];
+    /**
+     * Number of segments in the queue.
+     */
+    uint8_t queue_size;
+    #endif
 } pbio_control_t;
 
 // Time and reference functions:
@@ -199,11 +239,27 @@ pbio_dcmotor_actuation_t pbio_control_passive_completion_to_actuation_type(pbio_
 
 // Start new control command:
 
-pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift);
+pbio_error_t pbio_control_prepare_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion, pbio_trajectory_t *trajectory);
+void pbio_control_start_prepared_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_trajectory_t *trajectory, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t distance, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift);
 pbio_error_t pbio_control_start_position_control_hold(pbio_control_t *ctl, uint32_t time_now, int32_t position);
 pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, uint32_t duration, int32_t speed, pbio_control_on_completion_t on_completion);
 
+// Queue control commands:
+
+#if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+pbio_error_t pbio_control_queue_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion);
+uint8_t pbio_control_queue_get_size(const pbio_control_t *ctl);
+#else
+static inline pbio_error_t pbio_control_queue_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+static inline uint8_t pbio_control_queue_get_size(const pbio_control_t *ctl) {
+    return 0;
+}
+#endif // PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
 #endif // _PBIO_CONTROL_H_
 
 /** @} */
@@ -77,6 +77,14 @@ typedef struct _pbio_control_settings_t {
      * Absolute rate of change of the speed during off-ramp of the maneuver.
      */
     int32_t deceleration;
+    /**
+     * Time to ramp the acceleration up to its magnitude at the start of the
+     * on-ramp and off-ramp, and back down at the end. If this is zero, the
+     * acceleration changes instantly, giving a trapezoidal speed profile.
+     * Otherwise the rate of change of acceleration (jerk) is limited, giving
+     * an S-curve that does not excite mechanisms as much.
+     */
+    uint32_t jerk_time;
     /**
      * Maximum feedback actuation value. On a motor this is the maximum torque.
      */
@@ -146,6 +154,8 @@ int32_t pbio_control_settings_div_by_gain(int32_t value, int32_t gain);
 
 void pbio_control_settings_get_trajectory_limits(const pbio_control_settings_t *s, int32_t *speed, int32_t *acceleration, int32_t *deceleration);
 pbio_error_t pbio_control_settings_set_trajectory_limits(pbio_control_settings_t *s, int32_t speed, int32_t acceleration, int32_t deceleration);
+uint32_t pbio_control_settings_get_jerk_time(const pbio_control_settings_t *s);
+pbio_error_t pbio_control_settings_set_jerk_time(pbio_control_settings_t *s, uint32_t time);
 int32_t pbio_control_settings_get_actuation_limit(const pbio_control_settings_t *s);
 pbio_error_t pbio_control_settings_set_actuation_limit(pbio_control_settings_t *s, int32_t limit);
 void pbio_control_settings_get_pid(const pbio_control_settings_t *s, int32_t *pid_kp, int32_t *pid_ki, int32_t *pid_kd, int32_t *integral_deadzone, int32_t *integral_change_max);
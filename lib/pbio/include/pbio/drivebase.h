@@ -27,6 +27,10 @@ typedef struct _pbio_drivebase_t {
      * Synchronization state to indicate that one or more controllers are paused.
      */
     bool control_paused;
+    /**
+     * Number of control loops since the last controller update.
+     */
+    uint8_t update_count;
     pbio_servo_t *left;
     pbio_servo_t *right;
     pbio_control_t control_heading;
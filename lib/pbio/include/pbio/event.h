@@ -4,6 +4,8 @@
 #ifndef _PBIO_EVENT_H_
 #define _PBIO_EVENT_H_
 
+#include <stddef.h>
+
 /**
  * Contiki process events.
  */
@@ -14,4 +16,18 @@ typedef enum {
     PBIO_EVENT_STATUS_CLEARED,
 } pbio_event_t;
 
+/**
+ * Handler that is called when an operation on @p source is ready, such as a
+ * controller that completed its maneuver or a device that completed a mode
+ * switch. This lets the application wake up whatever waits on @p source
+ * instead of polling it.
+ *
+ * @param [in]  source      The object that is now ready.
+ */
+typedef void (*pbio_event_ready_handler_t)(const void *source);
+
+void pbio_event_set_ready_handler(pbio_event_ready_handler_t handler);
+
+void pbio_event_post_ready(const void *source);
+
 #endif // _PBIO_EVENT_H_
@@ -60,7 +60,7 @@ void pbio_position_integrator_pause(pbio_position_integrator_t *itg, uint32_t ti
 bool pbio_position_integrator_is_paused(const pbio_position_integrator_t *itg);
 void pbio_position_integrator_resume(pbio_position_integrator_t *itg, uint32_t time_now);
 void pbio_position_integrator_reset(pbio_position_integrator_t *itg, pbio_control_settings_t *settings, uint32_t time_now);
-int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t position_error, int32_t target_error);
+int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t position_error, int32_t target_error, uint8_t interval);
 bool pbio_position_integrator_stalled(const pbio_position_integrator_t *itg, uint32_t time_now, int32_t speed_now, int32_t speed_ref);
 
 #endif // _PBIO_INTEGRATOR_H_
@@ -28,17 +28,38 @@ typedef struct _pbio_log_t {
      */
     bool active;
     /**
-     * Number of columns.
+     * Whether the buffer is used as a ring buffer that is drained by a
+     * consumer while logging continues, instead of filling it just once.
+     */
+    bool stream;
+    /**
+     * Number of columns stored per row, including the default columns.
      */
     uint8_t num_cols;
+    /**
+     * Bit mask of the values given to ::pbio_logger_add_row that are stored.
+     * Bit 0 corresponds to the first value after the default columns.
+     */
+    uint32_t columns;
     /**
      * Number of rows.
      */
     uint32_t num_rows;
     /**
-     * How many rows have been used (filled) so far.
+     * How many rows have been used (filled) so far. Only the producer
+     * (the control loop) writes this value.
      */
     uint32_t num_rows_used;
+    /**
+     * How many rows have been consumed so far in streaming mode. Only the
+     * consumer (the user program or host link) writes this value.
+     */
+    uint32_t num_rows_read;
+    /**
+     * How many rows were discarded in streaming mode because the consumer
+     * did not keep up.
+     */
+    uint32_t num_rows_dropped;
     /**
      * Data buffer allocated by external application.
      */
@@ -64,23 +85,76 @@ typedef struct _pbio_log_t {
 // Number of values logged by the logger itself, such as time of call to logger
 #define PBIO_LOGGER_NUM_DEFAULT_COLS (1)
 
-void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample);
+/**
+ * Column mask that selects the first @p num_values values of each row.
+ */
+#define PBIO_LOGGER_COLUMNS_ALL(num_values) ((uint32_t)((1ULL << (num_values)) - 1))
+
+/**
+ * Version of the binary log format produced by ::pbio_logger_encode_header.
+ */
+#define PBIO_LOGGER_BINARY_VERSION (1)
+
+/**
+ * Column encoding: zig-zag varint of the difference with the previous row.
+ */
+#define PBIO_LOGGER_BINARY_COLUMN_DELTA (1)
+
+/**
+ * Maximum number of bytes needed to encode one int32 value as a varint.
+ */
+#define PBIO_LOGGER_VARINT_SIZE_MAX (5)
+
+/**
+ * Size of the binary log header, excluding one column descriptor per column.
+ */
+#define PBIO_LOGGER_BINARY_HEADER_SIZE (10)
+
+uint8_t pbio_logger_get_num_cols(uint32_t columns);
+void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample);
+void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample);
 void pbio_logger_stop(pbio_log_t *log);
 bool pbio_logger_is_active(const pbio_log_t *log);
+
+/**
+ * Checks if a value is stored in the log, so producers can skip computing
+ * values that nobody reads.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  index       Index of the value in the row given to ::pbio_logger_add_row.
+ * @return                  True if the value is stored, else false.
+ */
+static inline bool pbio_logger_column_is_enabled(const pbio_log_t *log, uint8_t index) {
+    return log->columns & (1UL << index);
+}
 void pbio_logger_add_row(pbio_log_t *log, const int32_t *row_data);
 
 uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log);
 int32_t *pbio_logger_get_row_data(const pbio_log_t *log, uint32_t index);
+void pbio_logger_consume_rows(pbio_log_t *log, uint32_t num_rows);
+uint32_t pbio_logger_get_num_rows_dropped(const pbio_log_t *log);
+
+uint32_t pbio_logger_encode_varint(uint8_t *buf, int32_t value);
+uint32_t pbio_logger_encode_header(const pbio_log_t *log, uint8_t *buf);
+uint32_t pbio_logger_encode_row(const pbio_log_t *log, uint32_t index, uint8_t *buf);
 
 #else
 
-static inline void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
+static inline uint8_t pbio_logger_get_num_cols(uint32_t columns) {
+    return 0;
+}
+static inline void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample) {
+}
+static inline void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample) {
 }
 static inline void pbio_logger_stop(pbio_log_t *log) {
 }
 static inline bool pbio_logger_is_active(const pbio_log_t *log) {
     return false;
 }
+static inline bool pbio_logger_column_is_enabled(const pbio_log_t *log, uint8_t index) {
+    return false;
+}
 static inline void pbio_logger_add_row(pbio_log_t *log, const int32_t *row_data) {
 }
 static inline uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log) {
@@ -89,6 +163,20 @@ static inline uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log) {
 static inline int32_t *pbio_logger_get_row_data(pbio_log_t *log, uint32_t index) {
     return NULL;
 }
+static inline void pbio_logger_consume_rows(pbio_log_t *log, uint32_t num_rows) {
+}
+static inline uint32_t pbio_logger_get_num_rows_dropped(const pbio_log_t *log) {
+    return 0;
+}
+static inline uint32_t pbio_logger_encode_varint(uint8_t *buf, int32_t value) {
+    return 0;
+}
+static inline uint32_t pbio_logger_encode_header(const pbio_log_t *log, uint8_t *buf) {
+    return 0;
+}
+static inline uint32_t pbio_logger_encode_row(const pbio_log_t *log, uint32_t index, uint8_t *buf) {
+    return 0;
+}
 
 #endif // PBIO_CONFIG_LOGGER
 
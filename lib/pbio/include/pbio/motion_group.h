@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+/**
+ * @addtogroup MotionGroup pbio/motion_group: Synchronized servo motion
+ *
+ * Runs several servos to a target such that they all start and finish
+ * together.
+ * @{
+ */
+
+#ifndef _PBIO_MOTION_GROUP_H_
+#define _PBIO_MOTION_GROUP_H_
+
+#include <pbio/config.h>
+
+#if PBIO_CONFIG_MOTION_GROUP
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbio/control.h>
+#include <pbio/error.h>
+#include <pbio/servo.h>
+
+/**
+ * Group of servos that move together.
+ */
+typedef struct _pbio_motion_group_t {
+    /**
+     * The servos in this group.
+     */
+    pbio_servo_t *servos[PBIO_CONFIG_SERVO_NUM_DEV];
+    /**
+     * Number of servos in this group.
+     */
+    uint8_t num_servos;
+} pbio_motion_group_t;
+
+pbio_error_t pbio_motion_group_setup(pbio_motion_group_t *group, pbio_servo_t *const *servos, uint8_t num_servos);
+
+// Motion group status:
+
+bool pbio_motion_group_update_loop_is_running(pbio_motion_group_t *group);
+bool pbio_motion_group_is_done(const pbio_motion_group_t *group);
+
+// Synchronized control:
+
+pbio_error_t pbio_motion_group_run_target(pbio_motion_group_t *group, int32_t speed, const int32_t *targets, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_motion_group_run_targets(pbio_motion_group_t *group, const int32_t *speeds, const int32_t *targets, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_motion_group_stop(pbio_motion_group_t *group, pbio_control_on_completion_t on_completion);
+
+#endif // PBIO_CONFIG_MOTION_GROUP
+
+#endif // _PBIO_MOTION_GROUP_H_
+
+/** @} */
@@ -11,8 +11,73 @@
 #ifndef _PBIO_MOTOR_PROCESS_H_
 #define _PBIO_MOTOR_PROCESS_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <pbio/config.h>
 
+// Override to enable control loop timing statistics.
+#ifndef PBIO_CONFIG_MOTOR_PROCESS_STATS
+#define PBIO_CONFIG_MOTOR_PROCESS_STATS (0)
+#endif
+
+/**
+ * Number of bins in a timing histogram.
+ */
+#define PBIO_MOTOR_PROCESS_STATS_NUM_BINS (8)
+
+/**
+ * Upper limit (exclusive) of the first bin of a timing histogram, in
+ * microseconds. Each next bin is twice as wide. The last bin counts all
+ * longer durations.
+ */
+#define PBIO_MOTOR_PROCESS_STATS_BIN_US (32)
+
+/**
+ * Histogram of durations in microseconds.
+ */
+typedef struct _pbio_motor_process_histogram_t {
+    /**
+     * Number of samples in each bin.
+     */
+    uint32_t bins[PBIO_MOTOR_PROCESS_STATS_NUM_BINS];
+    /**
+     * Longest duration so far.
+     */
+    uint32_t max;
+} pbio_motor_process_histogram_t;
+
+/**
+ * Timing statistics of the motor control loop.
+ */
+typedef struct _pbio_motor_process_stats_t {
+    /**
+     * Number of control loop updates.
+     */
+    uint32_t num_updates;
+    /**
+     * Number of updates that were delayed by more than twice the loop time,
+     * after which the loop timer was re-phased.
+     */
+    uint32_t num_overruns;
+    /**
+     * Deviation of the time between two updates from the nominal loop time.
+     */
+    pbio_motor_process_histogram_t jitter;
+    /**
+     * Execution time of the battery update.
+     */
+    pbio_motor_process_histogram_t battery;
+    /**
+     * Execution time of all drivebase updates.
+     */
+    pbio_motor_process_histogram_t drivebase;
+    /**
+     * Execution time of all servo updates.
+     */
+    pbio_motor_process_histogram_t servo;
+} pbio_motor_process_stats_t;
+
 #if PBIO_CONFIG_MOTOR_PROCESS
 
 // Override to disable automatic start of control process for tests.
@@ -29,6 +94,22 @@ static inline void pbio_motor_process_start(void) {
 
 #endif // PBIO_CONFIG_MOTOR_PROCESS
 
+#if PBIO_CONFIG_MOTOR_PROCESS && PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+const pbio_motor_process_stats_t *pbio_motor_process_get_stats(void);
+void pbio_motor_process_reset_stats(void);
+
+#else
+
+static inline const pbio_motor_process_stats_t *pbio_motor_process_get_stats(void) {
+    return NULL;
+}
+
+static inline void pbio_motor_process_reset_stats(void) {
+}
+
+#endif // PBIO_CONFIG_MOTOR_PROCESS && PBIO_CONFIG_MOTOR_PROCESS_STATS
+
 #endif // _PBIO_MOTOR_PROCESS_H_
 
 /** @} */
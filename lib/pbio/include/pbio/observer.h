@@ -21,6 +21,18 @@
 #include <pbio/differentiator.h>
 #include <pbio/angle.h>
 
+// Values generated by pbio/doc/control/model.py
+#define PBIO_OBSERVER_MAX_NUM_SPEED (2500000)
+#define PBIO_OBSERVER_MAX_NUM_ACCELERATION (25000000)
+#define PBIO_OBSERVER_MAX_NUM_CURRENT (30000)
+#define PBIO_OBSERVER_MAX_NUM_VOLTAGE (12000)
+#define PBIO_OBSERVER_MAX_NUM_TORQUE (1000000)
+#define PBIO_OBSERVER_PRESCALE_SPEED (858)
+#define PBIO_OBSERVER_PRESCALE_ACCELERATION (85)
+#define PBIO_OBSERVER_PRESCALE_CURRENT (71582)
+#define PBIO_OBSERVER_PRESCALE_VOLTAGE (178956)
+#define PBIO_OBSERVER_PRESCALE_TORQUE (2147)
+
 /**
  * Device-type specific constants that describe the motor model.
  */
@@ -42,8 +54,42 @@ typedef struct _pbio_observer_model_t {
     int32_t d_torque_d_speed;
     int32_t d_torque_d_acceleration;
     int32_t torque_friction;
+    /**
+     * The first twelve d_x_d_y values above as fixed-point reciprocals, so
+     * that the observer update does not need divisions. Multiplying a signal
+     * by this and shifting right by ::PBIO_OBSERVER_RECIPROCAL_SHIFT is the
+     * same as scaling it by its prescaler and dividing it by d_x_d_y.
+     */
+    int32_t d_angle_d_speed_reciprocal;
+    int32_t d_speed_d_speed_reciprocal;
+    int32_t d_current_d_speed_reciprocal;
+    int32_t d_angle_d_current_reciprocal;
+    int32_t d_speed_d_current_reciprocal;
+    int32_t d_current_d_current_reciprocal;
+    int32_t d_angle_d_voltage_reciprocal;
+    int32_t d_speed_d_voltage_reciprocal;
+    int32_t d_current_d_voltage_reciprocal;
+    int32_t d_angle_d_torque_reciprocal;
+    int32_t d_speed_d_torque_reciprocal;
+    int32_t d_current_d_torque_reciprocal;
 } pbio_observer_model_t;
 
+/**
+ * Number of fractional bits in the observer model reciprocals.
+ */
+#define PBIO_OBSERVER_RECIPROCAL_SHIFT (24)
+
+/**
+ * Multiplies a signal by an observer model reciprocal.
+ *
+ * @param [in]  value       The signal.
+ * @param [in]  reciprocal  The reciprocal of the model coefficient.
+ * @return                  The scaled signal, rounded to the nearest integer.
+ */
+static inline int32_t pbio_observer_model_scale(int32_t value, int32_t reciprocal) {
+    return ((int64_t)value * reciprocal + (1 << (PBIO_OBSERVER_RECIPROCAL_SHIFT - 1))) >> PBIO_OBSERVER_RECIPROCAL_SHIFT;
+}
+
 /**
  * Configurable observer settings.
  */
@@ -24,7 +24,7 @@
 #define PBIO_PROTOCOL_VERSION_MAJOR 1
 
 /** The minor version number for the protocol. */
-#define PBIO_PROTOCOL_VERSION_MINOR 3
+#define PBIO_PROTOCOL_VERSION_MINOR 4
 
 /** The patch version number for the protocol. */
 #define PBIO_PROTOCOL_VERSION_PATCH 0
@@ -122,8 +122,45 @@ typedef enum {
      * @since Pybricks Profile v1.3.0
      */
     PBIO_PYBRICKS_COMMAND_WRITE_STDIN = 6,
+
+    /**
+     * Requests checksums of consecutive blocks of user RAM.
+     *
+     * The hub replies with a ::PBIO_PYBRICKS_EVENT_USER_RAM_CHECKSUMS event.
+     * This lets the host compare the program that is already on the hub with
+     * a new program, and write only the blocks that changed.
+     *
+     * Parameters:
+     * - offset: The offset of the first block from the user RAM base address (32-bit little-endian unsigned integer).
+     * - size: The size of each block in bytes (32-bit little-endian unsigned integer).
+     * - count: The number of blocks (8-bit unsigned integer, 1 to ::PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX).
+     *
+     * The blocks may span at most ::PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE
+     * bytes in total, so that the hub is not blocked for too long.
+     *
+     * Errors:
+     * - ::PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED if the blocks are outside of the user RAM
+     *   or larger than ::PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE in total.
+     * - ::PBIO_PYBRICKS_ERROR_BUSY if a user program is running or if the reply
+     *   to a previous request was not sent yet.
+     *
+     * @since Pybricks Profile v1.4.0
+     */
+    PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS = 7,
 } pbio_pybricks_command_t;
 
+/**
+ * Maximum number of blocks in a ::PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS
+ * request, so that the reply fits in the minimum characteristic size.
+ */
+#define PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX 3
+
+/**
+ * Maximum total number of bytes in a
+ * ::PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS request.
+ */
+#define PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE 4096
+
 /**
  * Application-specific error codes that are used in ATT_ERROR_RSP.
  */
@@ -179,6 +216,20 @@ typedef enum {
      * @since Pybricks Profile v1.3.0
      */
     PBIO_PYBRICKS_EVENT_WRITE_STDOUT = 1,
+
+    /**
+     * User RAM checksums event.
+     *
+     * Sent in reply to ::PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS.
+     *
+     * The payload is the offset of the first block (32-bit little-endian
+     * unsigned integer) followed by the CRC-32 checksum of each requested
+     * block (32-bit little-endian unsigned integers). This is the same
+     * checksum as computed by zlib.crc32().
+     *
+     * @since Pybricks Profile v1.4.0
+     */
+    PBIO_PYBRICKS_EVENT_USER_RAM_CHECKSUMS = 2,
 } pbio_pybricks_event_t;
 
 /**
@@ -283,6 +334,13 @@ typedef enum {
      * @since Pybricks Profile v1.3.0.
      */
     PBIO_PYBRICKS_FEATURE_USER_PROG_FORMAT_MULTI_MPY_V6_1_NATIVE = 1 << 2,
+    /**
+     * Hub supports reading checksums of user RAM, so that only changed
+     * parts of a program have to be downloaded.
+     *
+     * @since Pybricks Profile v1.4.0.
+     */
+    PBIO_PYBRICKS_FEATURE_USER_RAM_CHECKSUMS = 1 << 3,
 } pbio_pybricks_feature_flags_t;
 
 void pbio_pybricks_hub_capabilities(uint8_t *buf,
@@ -39,6 +39,18 @@
 
 #include <pbdrv/legodev.h>
 
+/**
+ * Default number of control loops between controller updates for servos that
+ * are done and holding or stationary. Active servos are always updated on
+ * every loop.
+ */
+#ifndef PBIO_CONFIG_SERVO_UPDATE_DIVISOR_IDLE
+#define PBIO_CONFIG_SERVO_UPDATE_DIVISOR_IDLE (1)
+#endif
+
+/** Maximum number of control loops between controller updates of idle servos. */
+#define PBIO_SERVO_UPDATE_DIVISOR_MAX (10)
+
 /** Number of values per row when servo data logger is active. */
 #define PBIO_SERVO_LOGGER_NUM_COLS (10)
 
@@ -85,6 +97,15 @@ typedef struct _pbio_servo_t {
      * occur.
      */
     bool run_update_loop;
+    /**
+     * Number of control loops between controller updates while the servo is
+     * idle, that is, done with its maneuver and holding or stationary.
+     */
+    uint8_t update_divisor;
+    /**
+     * Number of control loops since the last controller update.
+     */
+    uint8_t update_count;
 } pbio_servo_t;
 
 /**
@@ -138,12 +159,14 @@ typedef struct _pbio_servo_settings_reduced_t {
 /**@{*/
 pbio_error_t pbio_servo_get_servo(pbdrv_legodev_dev_t *legodev, pbio_servo_t **srv);
 pbio_error_t pbio_servo_setup(pbio_servo_t *srv, pbdrv_legodev_type_id_t type, pbio_direction_t direction, int32_t gear_ratio, bool reset_angle, int32_t precision_profile);
+pbio_error_t pbio_servo_set_update_divisor(pbio_servo_t *srv, uint8_t divisor);
 /**@}*/
 
 /** @cond INTERNAL */
 pbio_error_t pbio_servo_actuate(pbio_servo_t *srv, pbio_dcmotor_actuation_t actuation_type, int32_t payload);
 const pbio_servo_settings_reduced_t *pbio_servo_get_reduced_settings(pbdrv_legodev_type_id_t id);
 void pbio_servo_update_all(void);
+pbio_error_t pbio_servo_update_with_angle(pbio_servo_t *srv, uint32_t time_now, const pbio_angle_t *angle);
 /** @endcond */
 
 /** @name Status Functions */
@@ -154,6 +177,7 @@ pbio_error_t pbio_servo_get_speed_user(pbio_servo_t *srv, uint32_t window, int32
 bool pbio_servo_update_loop_is_running(pbio_servo_t *srv);
 pbio_error_t pbio_servo_is_stalled(pbio_servo_t *srv, bool *stalled, uint32_t *stall_duration);
 pbio_error_t pbio_servo_get_load(pbio_servo_t *srv, int32_t *load);
+uint8_t pbio_servo_get_update_divisor(const pbio_servo_t *srv);
 /**@}*/
 
 /** @name Operation Functions */
@@ -165,6 +189,7 @@ pbio_error_t pbio_servo_run_time(pbio_servo_t *srv, int32_t speed, uint32_t dura
 pbio_error_t pbio_servo_run_until_stalled(pbio_servo_t *srv, int32_t speed, int32_t torque_limit, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_run_angle(pbio_servo_t *srv, int32_t speed, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_run_target(pbio_servo_t *srv, int32_t speed, int32_t target, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_servo_queue_target(pbio_servo_t *srv, int32_t speed, int32_t target, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_track_target(pbio_servo_t *srv, int32_t target);
 /**@}*/
 
@@ -17,8 +17,15 @@
 #include <stdint.h>
 
 #include <pbio/angle.h>
+#include <pbio/config.h>
 #include <pbio/error.h>
 
+// Number of solved angle trajectories to keep for reuse by identical
+// commands. Set to 0 to disable the cache.
+#ifndef PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+#define PBIO_CONFIG_TRAJECTORY_CACHE_SIZE (0)
+#endif
+
 // Trajectories use sub-millisecond steps for increased resolution.
 #define PBIO_TRAJECTORY_TICKS_PER_MS (10)
 
@@ -28,6 +35,10 @@
 // acceleration part of the maneuver.
 #define PBIO_TRAJECTORY_DURATION_FOREVER_MS (5 * 60 * 1000)
 
+// Upper bound on the time to ramp the acceleration up or down in jerk-limited
+// trajectories.
+#define PBIO_TRAJECTORY_JERK_TIME_MAX_MS (500)
+
 /**
  * Minimal set of trajectory parameters from which a full trajectory is
  * calculated. All values in control units and time in ticks.
@@ -42,6 +53,7 @@ typedef struct _pbio_trajectory_command_t {
     int32_t speed_max;             /**<  Max target rate target */
     int32_t acceleration;          /**<  Encoder acceleration magnitude during in-phase */
     int32_t deceleration;          /**<  Encoder acceleration magnitude during out-phase */
+    uint32_t jerk_time;            /**<  Time to ramp acceleration up to its magnitude, or 0 for constant acceleration phases */
     bool continue_running;         /**<  Whether it movement continues after t3 (true) or not (false) */
 } pbio_trajectory_command_t;
 
@@ -75,17 +87,34 @@ typedef struct _pbio_trajectory_t {
     int32_t w3;                          /**<  Encoder rate target after the maneuver ends */
     int32_t a0;                          /**<  Encoder acceleration during in-phase */
     int32_t a2;                          /**<  Encoder acceleration during out-phase */
+    int32_t tj0;                         /**<  Time to ramp acceleration up to a0 and back down during in-phase, or 0 if constant */
+    int32_t tj2;                         /**<  Time to ramp acceleration up to a2 and back down during out-phase, or 0 if constant */
 } pbio_trajectory_t;
 
 // Make or modify trajectories:
 
 pbio_error_t pbio_trajectory_validate_speed_limit(int32_t ctl_steps_per_app_step, int32_t speed);
 pbio_error_t pbio_trajectory_validate_acceleration_limit(int32_t ctl_steps_per_app_step, int32_t acceleration);
+pbio_error_t pbio_trajectory_validate_jerk_time(uint32_t jerk_time);
 pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
 pbio_error_t pbio_trajectory_new_time_command(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
 void pbio_trajectory_make_constant(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
 void pbio_trajectory_stretch(pbio_trajectory_t *trj, const pbio_trajectory_t *leader);
 
+// Trajectory cache statistics:
+
+#if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+void pbio_trajectory_get_cache_stats(uint32_t *hits, uint32_t *misses);
+void pbio_trajectory_reset_cache(void);
+#else
+static inline void pbio_trajectory_get_cache_stats(uint32_t *hits, uint32_t *misses) {
+    *hits = 0;
+    *misses = 0;
+}
+static inline void pbio_trajectory_reset_cache(void) {
+}
+#endif // PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
 // Reference getter functions:
 
 uint32_t pbio_trajectory_get_duration(const pbio_trajectory_t *trj);
@@ -129,6 +129,8 @@ void pbio_uuid128_reverse_copy(uint8_t *dst, const uint8_t *src);
 
 bool pbio_oneshot(bool value, bool *state);
 
+uint32_t pbio_crc32(const uint8_t *data, uint32_t size);
+
 #endif // _PBIO_UTIL_H_
 
 /** @} */
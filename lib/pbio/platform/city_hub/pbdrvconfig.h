@@ -59,6 +59,7 @@
 #define PBDRV_CONFIG_LEGODEV_PUP_UART               (1)
 #define PBDRV_CONFIG_LEGODEV_MODE_INFO              (1)
 #define PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_DEV       (PBDRV_CONFIG_LEGODEV_PUP_NUM_EXT_DEV)
+#define PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES   (0)
 
 #define PBDRV_CONFIG_MOTOR_DRIVER                   (1)
 #define PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV           (2)
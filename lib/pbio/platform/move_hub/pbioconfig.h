@@ -9,12 +9,14 @@
 #define PBIO_CONFIG_IMU                     (0)
 #define PBIO_CONFIG_LIGHT                   (1)
 #define PBIO_CONFIG_LOGGER                  (0)
+#define PBIO_CONFIG_MOTION_GROUP            (0)
 #define PBIO_CONFIG_MOTOR_PROCESS           (1)
 #define PBIO_CONFIG_SERVO                   (1)
 #define PBIO_CONFIG_SERVO_NUM_DEV           (4)
 #define PBIO_CONFIG_SERVO_EV3_NXT           (0)
 #define PBIO_CONFIG_SERVO_PUP               (1)
 #define PBIO_CONFIG_SERVO_PUP_MOVE_HUB      (1)
+#define PBIO_CONFIG_SERVO_UPDATE_DIVISOR_IDLE (4)
 #define PBIO_CONFIG_TACHO                   (1)
 #define PBIO_CONFIG_CONTROL_MINIMAL         (1)
 
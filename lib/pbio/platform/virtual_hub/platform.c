@@ -99,3 +99,16 @@ const pbdrv_motor_driver_virtual_simulation_platform_data_t
         .endstop_angle_positive = INFINITY,
     },
 };
+
+const pbdrv_motor_driver_virtual_simulation_drivebase_platform_data_t
+    pbdrv_motor_driver_virtual_simulation_drivebase_platform_data = {
+    .left_index = 0,
+    .right_index = 1,
+    .left_direction = PBIO_DIRECTION_COUNTERCLOCKWISE,
+    .right_direction = PBIO_DIRECTION_CLOCKWISE,
+    .wheel_diameter = 56,
+    .axle_track = 112,
+    .mass = 0.8,
+    .inertia = 0.003,
+    .friction_coefficient = 0.8,
+};
@@ -5,12 +5,14 @@
 // Copyright (c) 2020-2023 LEGO System A/S
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include <pbdrv/clock.h>
 
 #include <pbio/config.h>
 #include <pbio/control.h>
+#include <pbio/event.h>
 #include <pbio/int_math.h>
 #include <pbio/trajectory.h>
 #include <pbio/integrator.h>
@@ -83,7 +85,12 @@ static pbio_control_on_completion_t pbio_control_on_completion_discard_smart(pbi
 }
 
 static void pbio_control_status_set(pbio_control_t *ctl, pbio_control_status_flag_t flag, bool set) {
+    // Let anything waiting on this controller know that it completed.
+    bool completed = flag == PBIO_CONTROL_STATUS_COMPLETE && set && !(ctl->status & flag);
     ctl->status = set ? ctl->status | flag : ctl->status & ~flag;
+    if (completed) {
+        pbio_event_post_ready(ctl);
+    }
 }
 
 static bool pbio_control_status_test(const pbio_control_t *ctl, pbio_control_status_flag_t flag) {
@@ -223,6 +230,143 @@ static int32_t pbio_control_get_pid_kp(const pbio_control_settings_t *settings,
     return pbio_int_math_max(kp_pwa, kp_target);
 }
 
+#if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
+static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, const pbio_angle_t *target, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift);
+
+/**
+ * Gets the on-completion type for a segment that is followed by another one.
+ *
+ * If the next segment continues in the same direction, the segment ends at
+ * speed so that the motion blends into the next segment. Otherwise it has to
+ * come to a stop first, so it holds until the next segment starts.
+ *
+ * @param [in]  start       Start position of the segment (control units).
+ * @param [in]  target      Target position of the segment (control units).
+ * @param [in]  next        The segment that follows.
+ * @return                  What to do on completion of the segment.
+ */
+static pbio_control_on_completion_t pbio_control_queue_get_blend(const pbio_angle_t *start, const pbio_angle_t *target, const pbio_control_segment_t *next) {
+    int32_t direction = pbio_int_math_sign(pbio_angle_diff_mdeg(target, start));
+    int32_t direction_next = pbio_int_math_sign(pbio_angle_diff_mdeg(&next->target, target));
+    return direction != 0 && direction == direction_next ?
+           PBIO_CONTROL_ON_COMPLETION_CONTINUE :
+           PBIO_CONTROL_ON_COMPLETION_HOLD;
+}
+
+/**
+ * Starts the next queued segment once the ongoing maneuver reaches its
+ * endpoint. The new segment branches off from the current reference, so
+ * motion proceeds without stopping if the previous segment ended at speed.
+ *
+ * @param [in]  ctl         The control instance.
+ * @param [in]  time_now    The wall time (ticks).
+ * @param [in]  state       The current state of the system being controlled (control units).
+ */
+static void pbio_control_queue_advance(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state) {
+
+    // Nothing to do if there are no segments waiting.
+    if (ctl->queue_size == 0 || !pbio_control_type_is_position(ctl)) {
+        return;
+    }
+
+    // Wait until the ongoing maneuver has reached its endpoint.
+    pbio_trajectory_reference_t end;
+    pbio_trajectory_get_endpoint(&ctl->trajectory, &end);
+    if (!pbio_control_settings_time_is_later(pbio_control_get_ref_time(ctl, time_now), end.time)) {
+        return;
+    }
+
+    // Take the next segment from the queue.
+    pbio_control_segment_t segment = ctl->queue[0];
+    ctl->queue_size--;
+    memmove(&ctl->queue[0], &ctl->queue[1], ctl->queue_size * sizeof(pbio_control_segment_t));
+
+    // Only the last segment uses the completion type given by the user.
+    pbio_control_on_completion_t on_completion = ctl->queue_size == 0 ?
+        segment.on_completion :
+        pbio_control_queue_get_blend(&end.position, &segment.target, &ctl->queue[0]);
+
+    // If the segment can't be started, drop the remaining segments so the
+    // ongoing maneuver completes as usual.
+    if (_pbio_control_start_position_control(ctl, time_now, state, &segment.target, segment.speed, on_completion, true) != PBIO_SUCCESS) {
+        ctl->queue_size = 0;
+    }
+}
+
+/**
+ * Queues a position target to run to after the ongoing maneuver.
+ *
+ * The motor process starts each segment as soon as the reference of the
+ * previous segment reaches its endpoint. Segments that continue in the same
+ * direction are blended by ending the previous segment at speed, without
+ * decelerating to a stop in between.
+ *
+ * If no position control is ongoing, the maneuver starts right away.
+ *
+ * @param [in]  ctl            The control instance.
+ * @param [in]  time_now       The wall time (ticks).
+ * @param [in]  state          The current state of the system being controlled (control units).
+ * @param [in]  position       The target position to run to (application units).
+ * @param [in]  speed          The top speed on the way to the target (application units). The sign is ignored. If zero, default speed is used.
+ * @param [in]  on_completion  What to do when reaching the target position, if no other segments follow.
+ * @return                     ::PBIO_ERROR_BUSY if the queue is full, otherwise same as pbio_control_start_position_control().
+ */
+pbio_error_t pbio_control_queue_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion) {
+
+    // If nothing is ongoing to queue behind, just start.
+    if (!pbio_control_type_is_position(ctl) || pbio_control_is_done(ctl)) {
+        return pbio_control_start_position_control(ctl, time_now, state, position, speed, on_completion, true);
+    }
+
+    if (ctl->queue_size == PBIO_CONFIG_CONTROL_QUEUE_SIZE) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    pbio_control_segment_t *segment = &ctl->queue[ctl->queue_size];
+    pbio_control_settings_app_to_ctl_long(&ctl->settings, position, &segment->target);
+    segment->speed = pbio_control_settings_app_to_ctl(&ctl->settings, speed);
+    segment->on_completion = on_completion;
+    ctl->queue_size++;
+
+    // Segments that are already waiting in the queue get their blending when
+    // they start. But the ongoing maneuver was planned as the final one, so
+    // it may have to be replanned to end at speed.
+    if (ctl->queue_size > 1 || ctl->on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE) {
+        return PBIO_SUCCESS;
+    }
+    pbio_trajectory_reference_t end;
+    pbio_trajectory_get_endpoint(&ctl->trajectory, &end);
+    if (pbio_control_queue_get_blend(&ctl->trajectory.start.position, &end.position, segment) != PBIO_CONTROL_ON_COMPLETION_CONTINUE) {
+        return PBIO_SUCCESS;
+    }
+    pbio_error_t err = _pbio_control_start_position_control(ctl, time_now, state, &end.position,
+        pbio_trajectory_get_abs_command_speed(&ctl->trajectory), PBIO_CONTROL_ON_COMPLETION_CONTINUE, true);
+    if (err != PBIO_SUCCESS) {
+        ctl->queue_size--;
+    }
+    return err;
+}
+
+/**
+ * Gets the number of segments waiting to run after the ongoing maneuver.
+ *
+ * @param [in]  ctl         The control instance.
+ * @return                  Number of queued segments.
+ */
+uint8_t pbio_control_queue_get_size(const pbio_control_t *ctl) {
+    return ctl->queue_size;
+}
+
+#define pbio_control_queue_clear(ctl) ((ctl)->queue_size = 0)
+
+#else
+
+#define pbio_control_queue_advance(ctl, time_now, state)
+#define pbio_control_queue_clear(ctl)
+
+#endif // PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
 /**
  * Updates the PID controller state to calculate the next actuation step.
  *
@@ -244,6 +388,9 @@ void pbio_control_update(
     int32_t *control,
     bool *external_pause) {
 
+    // Start the next queued maneuver if the ongoing one has ended.
+    pbio_control_queue_advance(ctl, time_now, state);
+
     // Get reference signals at the reference time point in the trajectory.
     // This compensates for any time we may have spent pausing when the motor was stalled.
     pbio_trajectory_get_reference(&ctl->trajectory, pbio_control_get_ref_time(ctl, time_now), ref);
@@ -264,7 +411,7 @@ void pbio_control_update(
         // Get error to final position, used below to adjust controls near end.
         target_error = pbio_angle_diff_mdeg(&ref_end.position, &state->position);
         // Update count integral error and get current error state
-        integral_error = pbio_position_integrator_update(&ctl->position_integrator, position_error, target_error);
+        integral_error = pbio_position_integrator_update(&ctl->position_integrator, position_error, target_error, ctl->update_interval);
         // For position control, the proportional term is the real position error.
         position_error_used = position_error;
     } else {
@@ -290,8 +437,8 @@ void pbio_control_update(
 
     // We want to stop building up further errors if we are at the proportional torque limit. So, we pause the trajectory
     // if we get at this limit. We wait a little longer though, to make sure it does not fall back to below the limit
-    // within one sample, which we can predict using the current rate times the loop time, with a factor two tolerance.
-    int32_t windup_margin = pbio_control_settings_mul_by_loop_time(pbio_int_math_abs(state->speed)) * 2;
+    // within one sample, which we can predict using the current rate times the update interval, with a factor two tolerance.
+    int32_t windup_margin = pbio_control_settings_mul_by_loop_time(pbio_int_math_abs(state->speed)) * ctl->update_interval * 2;
     int32_t max_windup_torque = ctl->settings.actuation_max_temporary + pbio_control_settings_mul_by_gain(windup_margin, ctl->settings.pid_kp);
 
     // Speed value that is rounded to zero if small. This is used for a
@@ -342,7 +489,8 @@ void pbio_control_update(
         pbio_control_check_completion(ctl, ref->time, state, &ref_end));
 
     // Save (low-pass filtered) load for diagnostics
-    ctl->pid_average = (ctl->pid_average * (100 - PBIO_CONFIG_CONTROL_LOOP_TIME_MS) + torque * PBIO_CONFIG_CONTROL_LOOP_TIME_MS) / 100;
+    int32_t average_weight = PBIO_CONFIG_CONTROL_LOOP_TIME_MS * ctl->update_interval;
+    ctl->pid_average = (ctl->pid_average * (100 - average_weight) + torque * average_weight) / 100;
 
     // Decide actuation based on control status.
     if (// Not on target yet, so keep actuating.
@@ -375,42 +523,55 @@ void pbio_control_update(
         pbio_control_start_position_control_hold(ctl, time_now, target);
     }
 
-    // Optionally log control data.
-    if (pbio_logger_is_active(&ctl->log)) {
-
-        // For speed control, we use a reference adjusted for pausing. This is
-        // accounted for above, but here we need it in angle units for logging.
-        pbio_angle_t ref_position_log = ref->position;
-        pbio_angle_add_mdeg(&ref_position_log, position_error_used - position_error);
-
-        int32_t log_data[] = {
-            // Column 0: Log time (added by logger).
-            // Column 1: Time since start of trajectory.
-            ref->time - ctl->trajectory.start.time,
-            // Column 2: Position in application units.
-            pbio_control_settings_ctl_to_app_long(&ctl->settings, &state->position),
-            // Column 3: Speed in application units.
-            pbio_control_settings_ctl_to_app(&ctl->settings, state->speed),
-            // Column 4: Actuation type (LSB 0--1), stall state (LSB 2), on target (LSB 3), pause integration (LSB 4).
-            *actuation | (ctl->status << 2) | ((int32_t)pause_integration << 4),
-            // Column 5: Actuation payload, e.g. torque.
-            *control,
-            // Column 6: Reference position in application units.
-            pbio_control_settings_ctl_to_app_long(&ctl->settings, &ref_position_log),
-            // Column 7: Reference speed in application units.
-            pbio_control_settings_ctl_to_app(&ctl->settings, ref->speed),
-            // Column 8: Estimated position in application units.
-            pbio_control_settings_ctl_to_app_long(&ctl->settings, &state->position_estimate),
-            // Column 9: Estimated speed in application units.
-            pbio_control_settings_ctl_to_app(&ctl->settings, state->speed_estimate),
-            // Column 10: P term of PID control in (uNm).
-            torque_proportional,
-            // Column 12: I term of PID control in (uNm).
-            torque_integral,
-            // Column 13: D term of PID control in (uNm).
-            torque_derivative,
-        };
-        pbio_logger_add_row(&ctl->log, log_data);
+    // Optionally log control data. Only values selected by the log columns
+    // are converted to application units.
+    pbio_log_t *log = &ctl->log;
+    if (pbio_logger_is_active(log)) {
+
+        int32_t log_data[PBIO_CONTROL_LOGGER_NUM_COLS] = { 0 };
+
+        // Column 0: Log time (added by logger).
+        // Column 1: Time since start of trajectory.
+        log_data[0] = ref->time - ctl->trajectory.start.time;
+        // Column 2: Position in application units.
+        if (pbio_logger_column_is_enabled(log, 1)) {
+            log_data[1] = pbio_control_settings_ctl_to_app_long(&ctl->settings, &state->position);
+        }
+        // Column 3: Speed in application units.
+        if (pbio_logger_column_is_enabled(log, 2)) {
+            log_data[2] = pbio_control_settings_ctl_to_app(&ctl->settings, state->speed);
+        }
+        // Column 4: Actuation type (LSB 0--1), stall state (LSB 2), on target (LSB 3), pause integration (LSB 4).
+        log_data[3] = *actuation | (ctl->status << 2) | ((int32_t)pause_integration << 4);
+        // Column 5: Actuation payload, e.g. torque.
+        log_data[4] = *control;
+        // Column 6: Reference position in application units.
+        if (pbio_logger_column_is_enabled(log, 5)) {
+            // For speed control, we use a reference adjusted for pausing. This is
+            // accounted for above, but here we need it in angle units for logging.
+            pbio_angle_t ref_position_log = ref->position;
+            pbio_angle_add_mdeg(&ref_position_log, position_error_used - position_error);
+            log_data[5] = pbio_control_settings_ctl_to_app_long(&ctl->settings, &ref_position_log);
+        }
+        // Column 7: Reference speed in application units.
+        if (pbio_logger_column_is_enabled(log, 6)) {
+            log_data[6] = pbio_control_settings_ctl_to_app(&ctl->settings, ref->speed);
+        }
+        // Column 8: Estimated position in application units.
+        if (pbio_logger_column_is_enabled(log, 7)) {
+            log_data[7] = pbio_control_settings_ctl_to_app_long(&ctl->settings, &state->position_estimate);
+        }
+        // Column 9: Estimated speed in application units.
+        if (pbio_logger_column_is_enabled(log, 8)) {
+            log_data[8] = pbio_control_settings_ctl_to_app(&ctl->settings, state->speed_estimate);
+        }
+        // Column 10: P term of PID control in (uNm).
+        log_data[9] = torque_proportional;
+        // Column 11: I term of PID control in (uNm).
+        log_data[10] = torque_integral;
+        // Column 12: D term of PID control in (uNm).
+        log_data[11] = torque_derivative;
+        pbio_logger_add_row(log, log_data);
     }
 }
 
@@ -422,6 +583,7 @@ void pbio_control_update(
  */
 void pbio_control_stop(pbio_control_t *ctl) {
     ctl->type = PBIO_CONTROL_TYPE_NONE;
+    pbio_control_queue_clear(ctl);
     pbio_control_status_set(ctl, PBIO_CONTROL_STATUS_COMPLETE, true);
     pbio_control_status_set(ctl, PBIO_CONTROL_STATUS_STALLED, false);
     ctl->pid_average = 0;
@@ -490,11 +652,30 @@ void pbio_control_reset(pbio_control_t *ctl) {
     // Reset the previous on-completion state.
     ctl->on_completion = PBIO_CONTROL_ON_COMPLETION_COAST;
 
+    // Assume update on every loop unless the owner says otherwise.
+    ctl->update_interval = 1;
+
     // The on_completion state is the only persistent setting between
     // subsequent maneuvers, so nothing else needs to be reset explicitly.
 }
 
-static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, const pbio_angle_t *target, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift) {
+/**
+ * Computes the trajectory to a target position, without starting it.
+ *
+ * The trajectory continues from the ongoing maneuver, if any, just like when
+ * starting it right away.
+ *
+ * @param [in]  ctl                    The control instance.
+ * @param [in]  time_now               The wall time (ticks).
+ * @param [in]  state                  The current state of the system being controlled (control units).
+ * @param [in]  target                 The target position to run to (control units).
+ * @param [in]  speed                  The top speed on the way to the target (control units). The sign is ignored. If zero, default speed is used.
+ * @param [in]  on_completion          What to do when reaching the target position.
+ * @param [in]  allow_trajectory_shift Whether trajectory may be time-shifted for better performance in tight loops (true) or not (false).
+ * @param [out] trajectory             The computed trajectory.
+ * @return                             Error code.
+ */
+static pbio_error_t pbio_control_get_position_trajectory(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, const pbio_angle_t *target, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift, pbio_trajectory_t *trajectory) {
 
     pbio_error_t err;
 
@@ -505,6 +686,7 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         .speed_max = ctl->settings.speed_max,
         .acceleration = ctl->settings.acceleration,
         .deceleration = ctl->settings.deceleration,
+        .jerk_time = ctl->settings.jerk_time,
         .continue_running = on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE,
     };
 
@@ -517,7 +699,7 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         command.speed_start = state->speed;
 
         // With the command fully populated, we can calculate the trajectory.
-        err = pbio_trajectory_new_angle_command(&ctl->trajectory, &command);
+        err = pbio_trajectory_new_angle_command(trajectory, &command);
         if (err != PBIO_SUCCESS) {
             return err;
         }
@@ -531,7 +713,7 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         command.speed_start = ref.speed;
 
         // With the command fully populated, we can calculate the trajectory.
-        err = pbio_trajectory_new_angle_command(&ctl->trajectory, &command);
+        err = pbio_trajectory_new_angle_command(trajectory, &command);
         if (err != PBIO_SUCCESS) {
             return err;
         }
@@ -545,14 +727,13 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         command.position_start = ref.position;
         command.speed_start = ref.speed;
 
-        // Before we override the trajectory to renew it, get the starting
-        // point of the current speed/angle segment of the reference. We may
-        // need it below.
+        // Get the starting point of the current speed/angle segment of the
+        // reference. We may need it below.
         pbio_trajectory_reference_t ref_vertex;
         pbio_trajectory_get_last_vertex(&ctl->trajectory, command.time_start, &ref_vertex);
 
         // With the command fully populated, we can calculate the trajectory.
-        err = pbio_trajectory_new_angle_command(&ctl->trajectory, &command);
+        err = pbio_trajectory_new_angle_command(trajectory, &command);
         if (err != PBIO_SUCCESS) {
             return err;
         }
@@ -561,7 +742,7 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         // better than just branching off. Instead, we can adjust the command
         // so it starts from the same point as the previous trajectory. This
         // avoids rounding errors when restarting commands in a tight loop.
-        if (ctl->trajectory.a0 == ref.acceleration && allow_trajectory_shift) {
+        if (trajectory->a0 == ref.acceleration && allow_trajectory_shift) {
 
             // Update command with shifted starting point, equal to ongoing
             // maneuver.
@@ -570,13 +751,25 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
             command.speed_start = ref_vertex.speed;
 
             // Recalculate the trajectory from the shifted starting point.
-            err = pbio_trajectory_new_angle_command(&ctl->trajectory, &command);
+            err = pbio_trajectory_new_angle_command(trajectory, &command);
             if (err != PBIO_SUCCESS) {
                 return err;
             }
         }
     }
 
+    return PBIO_SUCCESS;
+}
+
+static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, const pbio_angle_t *target, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift) {
+
+    pbio_trajectory_t trajectory;
+    pbio_error_t err = pbio_control_get_position_trajectory(ctl, time_now, state, target, speed, on_completion, allow_trajectory_shift, &trajectory);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    ctl->trajectory = trajectory;
+
     // Activate control type and reset integrators if needed.
     pbio_control_set_control_type(ctl, time_now, PBIO_CONTROL_TYPE_POSITION, on_completion);
 
@@ -588,22 +781,74 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
  *
  * In a servo application, this means running to a target angle.
  *
- * @param [in]  ctl            The control instance.
- * @param [in]  time_now       The wall time (ticks).
- * @param [in]  state          The current state of the system being controlled (control units).
- * @param [in]  position       The target position to run to (application units).
- * @param [in]  speed          The top speed on the way to the target (application units). The sign is ignored. If zero, default speed is used.
- * @param [in]  on_completion  What to do when reaching the target position.
- * @return                     Error code.
+ * @param [in]  ctl                    The control instance.
+ * @param [in]  time_now               The wall time (ticks).
+ * @param [in]  state                  The current state of the system being controlled (control units).
+ * @param [in]  position               The target position to run to (application units).
+ * @param [in]  speed                  The top speed on the way to the target (application units). The sign is ignored. If zero, default speed is used.
+ * @param [in]  on_completion          What to do when reaching the target position.
+ * @param [in]  allow_trajectory_shift Whether trajectory may be time-shifted for better performance in tight loops (true) or not (false).
+ * @return                             Error code.
  */
-pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion) {
+pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift) {
+
+    // A new command replaces any queued maneuvers.
+    pbio_control_queue_clear(ctl);
 
     // Convert target position to control units.
     pbio_angle_t target;
     pbio_control_settings_app_to_ctl_long(&ctl->settings, position, &target);
 
     // Start position control in control units.
-    return _pbio_control_start_position_control(ctl, time_now, state, &target, pbio_control_settings_app_to_ctl(&ctl->settings, speed), on_completion, true);
+    return _pbio_control_start_position_control(ctl, time_now, state, &target, pbio_control_settings_app_to_ctl(&ctl->settings, speed), on_completion, allow_trajectory_shift);
+}
+
+/**
+ * Computes the trajectory to a given target position without starting it.
+ *
+ * This lets callers that start several controllers at once check that all
+ * of them can start, before starting any of them. The controller must not be
+ * changed until the trajectory is started with
+ * pbio_control_start_prepared_position_control().
+ *
+ * @param [in]  ctl                    The control instance.
+ * @param [in]  time_now               The wall time (ticks).
+ * @param [in]  state                  The current state of the system being controlled (control units).
+ * @param [in]  position               The target position to run to (application units).
+ * @param [in]  speed                  The top speed on the way to the target (application units). The sign is ignored. If zero, default speed is used.
+ * @param [in]  on_completion          What to do when reaching the target position.
+ * @param [out] trajectory             The computed trajectory.
+ * @return                             Error code.
+ */
+pbio_error_t pbio_control_prepare_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion, pbio_trajectory_t *trajectory) {
+
+    // Convert target position to control units.
+    pbio_angle_t target;
+    pbio_control_settings_app_to_ctl_long(&ctl->settings, position, &target);
+
+    // Trajectory shifting is not allowed, since that would give trajectories
+    // prepared at the same time different starting times.
+    return pbio_control_get_position_trajectory(ctl, time_now, state, &target, pbio_control_settings_app_to_ctl(&ctl->settings, speed), on_completion, false, trajectory);
+}
+
+/**
+ * Starts position control along a trajectory from
+ * pbio_control_prepare_position_control(). This can't fail.
+ *
+ * @param [in]  ctl                    The control instance.
+ * @param [in]  time_now               The wall time (ticks), as given when preparing the trajectory.
+ * @param [in]  trajectory             The prepared trajectory.
+ * @param [in]  on_completion          What to do when reaching the target position, as given when preparing the trajectory.
+ */
+void pbio_control_start_prepared_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_trajectory_t *trajectory, pbio_control_on_completion_t on_completion) {
+
+    // A new command replaces any queued maneuvers.
+    pbio_control_queue_clear(ctl);
+
+    ctl->trajectory = *trajectory;
+
+    // Activate control type and reset integrators if needed.
+    pbio_control_set_control_type(ctl, time_now, PBIO_CONTROL_TYPE_POSITION, on_completion);
 }
 
 /**
@@ -625,6 +870,9 @@ pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t t
  */
 pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t distance, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift) {
 
+    // A new command replaces any queued maneuvers.
+    pbio_control_queue_clear(ctl);
+
     // Convert distance to control units.
     pbio_angle_t increment;
     pbio_control_settings_app_to_ctl_long(&ctl->settings, (speed < 0 ? -distance : distance), &increment);
@@ -674,6 +922,9 @@ pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, u
  */
 pbio_error_t pbio_control_start_position_control_hold(pbio_control_t *ctl, uint32_t time_now, int32_t position) {
 
+    // A new command replaces any queued maneuvers.
+    pbio_control_queue_clear(ctl);
+
     // Compute new maneuver based on user argument, starting from the initial state
     pbio_trajectory_command_t command = {
         .time_start = pbio_control_get_ref_time(ctl, time_now),
@@ -707,6 +958,9 @@ pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time
 
     pbio_error_t err;
 
+    // A new command replaces any queued maneuvers.
+    pbio_control_queue_clear(ctl);
+
     // For timed maneuvers, being "smart" by remembering the position endpoint
     // does nothing useful, so discard it to keep only the passive actuation type.
     on_completion = pbio_control_on_completion_discard_smart(on_completion);
@@ -719,6 +973,7 @@ pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time
         .speed_max = ctl->settings.speed_max,
         .acceleration = ctl->settings.acceleration,
         .deceleration = ctl->settings.deceleration,
+        .jerk_time = ctl->settings.jerk_time,
         .continue_running = on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE,
     };
 
@@ -865,11 +1120,13 @@ bool pbio_control_is_stalled(const pbio_control_t *ctl, uint32_t *stall_duration
 /**
  * Checks if the controller is done.
  *
- * For trajectories with a stationary endpoint, done means on target.
+ * For trajectories with a stationary endpoint, done means on target. It is
+ * not done while maneuvers are still queued.
  *
  * @param [in]  ctl             The control instance.
  * @return                      True if the controller is done, false if not.
  */
 bool pbio_control_is_done(const pbio_control_t *ctl) {
-    return !pbio_control_is_active(ctl) || pbio_control_status_test(ctl, PBIO_CONTROL_STATUS_COMPLETE);
+    return !pbio_control_is_active(ctl) ||
+           (pbio_control_status_test(ctl, PBIO_CONTROL_STATUS_COMPLETE) && pbio_control_queue_get_size(ctl) == 0);
 }
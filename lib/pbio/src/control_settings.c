@@ -209,6 +209,34 @@ pbio_error_t pbio_control_settings_set_trajectory_limits(pbio_control_settings_t
     return PBIO_SUCCESS;
 }
 
+/**
+ * Gets the time to ramp the acceleration up and down during each maneuver.
+ *
+ * @param [in]  s             Control settings structure from which to read.
+ * @return                    Jerk time (ms), or 0 if acceleration changes instantly.
+ */
+uint32_t pbio_control_settings_get_jerk_time(const pbio_control_settings_t *s) {
+    return pbio_control_time_ticks_to_ms(s->jerk_time);
+}
+
+/**
+ * Sets the time to ramp the acceleration up and down during each maneuver.
+ *
+ * @param [in] s              Control settings structure to write to.
+ * @param [in] time           Jerk time (ms), or 0 to change acceleration instantly.
+ * @return                    ::PBIO_SUCCESS on success
+ *                            ::PBIO_ERROR_INVALID_ARG if the time is too long.
+ */
+pbio_error_t pbio_control_settings_set_jerk_time(pbio_control_settings_t *s, uint32_t time) {
+    uint32_t jerk_time = pbio_control_time_ms_to_ticks(time);
+    pbio_error_t err = pbio_trajectory_validate_jerk_time(jerk_time);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    s->jerk_time = jerk_time;
+    return PBIO_SUCCESS;
+}
+
 /**
  * Gets the control limits for actuation, in application units.
  *
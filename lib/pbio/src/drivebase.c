@@ -83,6 +83,7 @@ static void drivebase_adopt_settings(pbio_control_settings_t *s_distance, pbio_c
         // Make acceleration, deceleration a bit slower for smoother driving.
         .acceleration = pbio_int_math_min(s_left->acceleration, s_right->acceleration) * 3 / 4,
         .deceleration = pbio_int_math_min(s_left->deceleration, s_right->deceleration) * 3 / 4,
+        .jerk_time = pbio_int_math_max(s_left->jerk_time, s_right->jerk_time),
         .actuation_max = actuation_max,
         .pid_kp = pid_kp,
         // Dynamic kp reduction is disabled for drivebases. Instead, it uses
@@ -170,6 +171,7 @@ static void pbio_drivebase_stop_drivebase_control(pbio_drivebase_t *db) {
     pbio_control_stop(&db->control_distance);
     pbio_control_stop(&db->control_heading);
     db->control_paused = false;
+    db->update_count = 0;
 }
 
 /**
@@ -294,6 +296,7 @@ pbio_error_t pbio_drivebase_get_drivebase(pbio_drivebase_t **db_address, pbio_se
     pbio_control_reset(&db->control_distance);
     pbio_control_reset(&db->control_heading);
     db->control_paused = false;
+    db->update_count = 0;
 
     // Reset both motors to a passive state
     pbio_drivebase_stop_servo_control(db);
@@ -416,6 +419,22 @@ static pbio_error_t pbio_drivebase_update(pbio_drivebase_t *db) {
         return PBIO_SUCCESS;
     }
 
+    // Like a servo, a drive base that is done and holding position doesn't
+    // need a controller update on every loop. It uses the update divisor of
+    // its servos, whichever updates more often. Meanwhile, the servos keep
+    // applying the last torque.
+    db->update_count++;
+    bool idle = pbio_drivebase_is_done(db) &&
+        db->control_distance.on_completion != PBIO_CONTROL_ON_COMPLETION_CONTINUE &&
+        db->control_heading.on_completion != PBIO_CONTROL_ON_COMPLETION_CONTINUE;
+    uint8_t update_divisor = pbio_int_math_min(pbio_servo_get_update_divisor(db->left), pbio_servo_get_update_divisor(db->right));
+    if (idle && db->update_count < update_divisor) {
+        return PBIO_SUCCESS;
+    }
+    db->control_distance.update_interval = db->update_count;
+    db->control_heading.update_interval = db->update_count;
+    db->update_count = 0;
+
     // Get current time
     uint32_t time_now = pbio_control_get_time_ticks();
 
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include <stddef.h>
+
+#include <pbio/event.h>
+
+static pbio_event_ready_handler_t ready_handler;
+
+/**
+ * Sets the handler for ready events.
+ *
+ * @param [in]  handler     The handler or NULL to disable it.
+ */
+void pbio_event_set_ready_handler(pbio_event_ready_handler_t handler) {
+    ready_handler = handler;
+}
+
+/**
+ * Informs the application that an operation on @p source is ready.
+ *
+ * @param [in]  source      The object that is now ready.
+ */
+void pbio_event_post_ready(const void *source) {
+    if (ready_handler) {
+        ready_handler(source);
+    }
+}
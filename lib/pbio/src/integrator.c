@@ -224,14 +224,15 @@ void pbio_position_integrator_reset(pbio_position_integrator_t *itg, pbio_contro
  * @param [in]    itg              Speed integrator instance.
  * @param [in]    position_error   Current position error (position control units).
  * @param [in]    target_error     Remaining error to the endpoint (position control units).
+ * @param [in]    interval         Number of control loops since the previous update.
  * @return                         Integrator state value (position control units).
  */
-int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t position_error, int32_t target_error) {
+int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t position_error, int32_t target_error, uint8_t interval) {
 
     int32_t error_now = position_error;
 
     // Check if integrator magnitude would decrease due to this error
-    bool decrease = pbio_int_math_abs(itg->count_err_integral + pbio_control_settings_mul_by_loop_time(error_now)) < pbio_int_math_abs(itg->count_err_integral);
+    bool decrease = pbio_int_math_abs(itg->count_err_integral + pbio_control_settings_mul_by_loop_time(error_now) * interval) < pbio_int_math_abs(itg->count_err_integral);
 
     // Integrate and update position error
     if (itg->trajectory_running || decrease) {
@@ -242,7 +243,7 @@ int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t
             error_now = error_now < -itg->settings->integral_change_max ? -itg->settings->integral_change_max : error_now;
 
             // It might be decreasing now after all (due to integral sign change), so re-evaluate
-            decrease = pbio_int_math_abs(itg->count_err_integral + pbio_control_settings_mul_by_loop_time(error_now)) < pbio_int_math_abs(itg->count_err_integral);
+            decrease = pbio_int_math_abs(itg->count_err_integral + pbio_control_settings_mul_by_loop_time(error_now) * interval) < pbio_int_math_abs(itg->count_err_integral);
         }
 
         // Specify in which region integral control should be active. This is
@@ -253,7 +254,7 @@ int32_t pbio_position_integrator_update(pbio_position_integrator_t *itg, int32_t
         // Add change if we are near (but not too near) target, or always if it decreases the integral magnitude.
         if ((pbio_int_math_abs(target_error) >= itg->settings->integral_deadzone &&
              pbio_int_math_abs(target_error) <= integral_range_upper) || decrease) {
-            itg->count_err_integral += pbio_control_settings_mul_by_loop_time(error_now);
+            itg->count_err_integral += pbio_control_settings_mul_by_loop_time(error_now) * interval;
         }
 
         // Limit integral to value that leads to maximum actuation, i.e. max actuation / ki.
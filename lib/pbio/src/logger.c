@@ -15,21 +15,30 @@
 #include <pbio/logger.h>
 
 /**
- * Starts logging in the background.
+ * Gets the number of columns stored per row for a given column selection.
  *
- * @param [in]  log         Pointer to log.
- * @param [in]  buf         Array large enough to hold @p num_rows rows of data.
- * @param [in]  num_rows    Maximum number of rows that can be logged.
- * @param [in]  num_cols    Number of entries in one row.
- * @param [in]  down_sample For every @p down_sample of update calls, only one row is logged.
+ * @param [in]  columns     Bit mask of values to store.
+ * @return                  Number of columns, including the default columns.
  */
-void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
+uint8_t pbio_logger_get_num_cols(uint32_t columns) {
+    uint8_t num_cols = PBIO_LOGGER_NUM_DEFAULT_COLS;
+    for (; columns; columns >>= 1) {
+        num_cols += columns & 1;
+    }
+    return num_cols;
+}
+
+static void pbio_logger_start_common(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample, bool stream) {
     // (re-)initialize logger status.
+    log->stream = stream;
     log->num_rows_used = 0;
+    log->num_rows_read = 0;
+    log->num_rows_dropped = 0;
     log->skipped_samples = 0;
     log->data = buf;
     log->num_rows = num_rows;
-    log->num_cols = num_cols;
+    log->columns = columns;
+    log->num_cols = pbio_logger_get_num_cols(columns);
     log->down_sample = down_sample;
     log->start_time = pbdrv_clock_get_ms();
 
@@ -37,6 +46,40 @@ void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t
     log->active = true;
 }
 
+/**
+ * Starts logging in the background.
+ *
+ * Logging stops automatically when the buffer is full.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  buf         Array large enough to hold @p num_rows rows of data.
+ * @param [in]  num_rows    Maximum number of rows that can be logged.
+ * @param [in]  columns     Bit mask of values to store from each row.
+ * @param [in]  down_sample For every @p down_sample of update calls, only one row is logged.
+ */
+void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample) {
+    pbio_logger_start_common(log, buf, num_rows, columns, down_sample, false);
+}
+
+/**
+ * Starts logging in the background, using the buffer as a ring buffer.
+ *
+ * The control loop is the only producer and the application is the only
+ * consumer. The consumer reads rows with ::pbio_logger_get_row_data and
+ * releases them with ::pbio_logger_consume_rows while logging continues. If
+ * the consumer does not keep up, new rows are dropped and counted instead of
+ * overwriting rows that may be in the process of being read.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  buf         Array large enough to hold @p num_rows rows of data.
+ * @param [in]  num_rows    Number of rows that can be buffered at once.
+ * @param [in]  columns     Bit mask of values to store from each row.
+ * @param [in]  down_sample For every @p down_sample of update calls, only one row is logged.
+ */
+void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint32_t columns, int32_t down_sample) {
+    pbio_logger_start_common(log, buf, num_rows, columns, down_sample, true);
+}
+
 /**
  * Stops accepting new data from background loops.
  *
@@ -59,6 +102,9 @@ bool pbio_logger_is_active(const pbio_log_t *log) {
 /**
  * Add new data from a background loop.
  *
+ * Only the values selected when starting the log are stored. The other
+ * values are not read, so they need not be computed.
+ *
  * @param [in]  log         Pointer to log.
  * @param [in]  row_data    Data to be added.
  */
@@ -70,44 +116,164 @@ void pbio_logger_add_row(pbio_log_t *log, const int32_t *row_data) {
     }
     log->skipped_samples = 0;
 
-    // Exit if log is full.
-    if (log->num_rows_used >= log->num_rows) {
+    // Handle full log.
+    if (log->num_rows_used - log->num_rows_read >= log->num_rows) {
+        // In streaming mode, drop this row until the consumer catches up.
+        if (log->stream) {
+            log->num_rows_dropped++;
+            return;
+        }
+        // Otherwise, stop logging.
         log->active = false;
         return;
     }
 
+    // Get row to write to. This is the next free row in the (ring) buffer.
+    int32_t *row = log->data + (log->num_rows_used % log->num_rows) * log->num_cols;
+
     // Write time of logging.
-    log->data[log->num_rows_used * log->num_cols] = pbdrv_clock_get_ms() - log->start_time;
+    row[0] = pbdrv_clock_get_ms() - log->start_time;
 
-    // Write the data.
-    for (uint8_t i = PBIO_LOGGER_NUM_DEFAULT_COLS; i < log->num_cols; i++) {
-        log->data[log->num_rows_used * log->num_cols + i] = row_data[i - PBIO_LOGGER_NUM_DEFAULT_COLS];
+    // Write the selected data.
+    uint8_t col = PBIO_LOGGER_NUM_DEFAULT_COLS;
+    for (uint8_t i = 0; col < log->num_cols; i++) {
+        if (pbio_logger_column_is_enabled(log, i)) {
+            row[col++] = row_data[i];
+        }
     }
 
-    // Increment used row counter.
+    // Increment used row counter only after the row is complete, so the
+    // consumer never sees a partially written row.
     log->num_rows_used++;
 
     return;
 }
 
 /**
- * Gets number of used (filled) rows in the log.
+ * Gets number of used (filled) rows in the log that have not been consumed.
  *
  * @param [in]  log         Pointer to log.
  * @return                  Number of used rows.
  */
 uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log) {
-    return log->num_rows_used;
+    return log->num_rows_used - log->num_rows_read;
 }
 
 /**
  * Gets row from the log. Caller must ensure that valid index is used.
  *
+ * In streaming mode, index 0 is the oldest row that has not been consumed.
+ *
  * @param [in]  log         Pointer to log.
+ * @param [in]  index       Index of the row, less than the number of used rows.
  * @return                  Pointer to row data.
  */
 int32_t *pbio_logger_get_row_data(const pbio_log_t *log, uint32_t index) {
-    return log->data + index * log->num_cols;
+    return log->data + ((log->num_rows_read + index) % log->num_rows) * log->num_cols;
+}
+
+/**
+ * Releases rows that have been read so the producer can reuse them.
+ *
+ * This has no effect if the log is not in streaming mode.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  num_rows    Number of rows to release, starting at the oldest.
+ */
+void pbio_logger_consume_rows(pbio_log_t *log, uint32_t num_rows) {
+    if (!log->stream) {
+        return;
+    }
+    uint32_t num_rows_used = pbio_logger_get_num_rows_used(log);
+    log->num_rows_read += num_rows < num_rows_used ? num_rows : num_rows_used;
+}
+
+/**
+ * Gets the number of rows dropped in streaming mode because the buffer was full.
+ *
+ * @param [in]  log         Pointer to log.
+ * @return                  Number of dropped rows.
+ */
+uint32_t pbio_logger_get_num_rows_dropped(const pbio_log_t *log) {
+    return log->num_rows_dropped;
+}
+
+/**
+ * Encodes a signed value as a zig-zag encoded variable length integer.
+ *
+ * Small values, positive or negative, take fewer bytes. Each byte holds 7 bits
+ * of data, least significant group first, with the MSB set on all but the
+ * last byte.
+ *
+ * @param [out] buf         Buffer of at least ::PBIO_LOGGER_VARINT_SIZE_MAX bytes.
+ * @param [in]  value       Value to encode.
+ * @return                  Number of bytes written.
+ */
+uint32_t pbio_logger_encode_varint(uint8_t *buf, int32_t value) {
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    uint32_t size = 0;
+    while (zigzag >= 0x80) {
+        buf[size++] = (zigzag & 0x7f) | 0x80;
+        zigzag >>= 7;
+    }
+    buf[size++] = zigzag;
+    return size;
+}
+
+/**
+ * Encodes the header of a binary log export.
+ *
+ * The header is the ASCII magic "PBLG", the format version, the number of
+ * columns, the number of rows as a little endian uint32, and then one byte
+ * per column describing how that column is encoded.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [out] buf         Buffer of at least ::PBIO_LOGGER_BINARY_HEADER_SIZE
+ *                          plus number of columns bytes.
+ * @return                  Number of bytes written.
+ */
+uint32_t pbio_logger_encode_header(const pbio_log_t *log, uint8_t *buf) {
+    uint32_t num_rows = pbio_logger_get_num_rows_used(log);
+    buf[0] = 'P';
+    buf[1] = 'B';
+    buf[2] = 'L';
+    buf[3] = 'G';
+    buf[4] = PBIO_LOGGER_BINARY_VERSION;
+    buf[5] = log->num_cols;
+    buf[6] = num_rows;
+    buf[7] = num_rows >> 8;
+    buf[8] = num_rows >> 16;
+    buf[9] = num_rows >> 24;
+    for (uint8_t i = 0; i < log->num_cols; i++) {
+        buf[PBIO_LOGGER_BINARY_HEADER_SIZE + i] = PBIO_LOGGER_BINARY_COLUMN_DELTA;
+    }
+    return PBIO_LOGGER_BINARY_HEADER_SIZE + log->num_cols;
+}
+
+/**
+ * Encodes one row of a binary log export.
+ *
+ * Each value is encoded as the difference with the same column in the
+ * previous row, so slowly changing signals take only one or two bytes. The
+ * first row is encoded relative to zero.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  index       Index of the row, as in ::pbio_logger_get_row_data.
+ * @param [out] buf         Buffer of at least ::PBIO_LOGGER_VARINT_SIZE_MAX
+ *                          times the number of columns bytes.
+ * @return                  Number of bytes written.
+ */
+uint32_t pbio_logger_encode_row(const pbio_log_t *log, uint32_t index, uint8_t *buf) {
+    const int32_t *row = pbio_logger_get_row_data(log, index);
+    const int32_t *prev = index > 0 ? pbio_logger_get_row_data(log, index - 1) : NULL;
+
+    uint32_t size = 0;
+    for (uint8_t i = 0; i < log->num_cols; i++) {
+        // Wrapping difference, so the decoder can undo it with wrapping addition.
+        int32_t delta = (int32_t)((uint32_t)row[i] - (prev ? (uint32_t)prev[i] : 0));
+        size += pbio_logger_encode_varint(buf + size, delta);
+    }
+    return size;
 }
 
 #endif // PBIO_CONFIG_LOGGER
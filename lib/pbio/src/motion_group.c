@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pbio/control.h>
+#include <pbio/motion_group.h>
+#include <pbio/parent.h>
+#include <pbio/servo.h>
+#include <pbio/trajectory.h>
+
+#if PBIO_CONFIG_MOTION_GROUP
+
+/**
+ * Sets up a group of servos that move together.
+ *
+ * @param [out] group       The motion group instance.
+ * @param [in]  servos      The servos in the group.
+ * @param [in]  num_servos  Number of servos in the group.
+ * @return                  ::PBIO_ERROR_INVALID_ARG if there are no servos,
+ *                          too many servos, or duplicate servos, otherwise
+ *                          ::PBIO_SUCCESS.
+ */
+pbio_error_t pbio_motion_group_setup(pbio_motion_group_t *group, pbio_servo_t *const *servos, uint8_t num_servos) {
+
+    if (num_servos == 0 || num_servos > PBIO_CONFIG_SERVO_NUM_DEV) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    for (uint8_t i = 0; i < num_servos; i++) {
+        // Each servo can only be controlled once.
+        for (uint8_t j = 0; j < i; j++) {
+            if (servos[i] == servos[j]) {
+                return PBIO_ERROR_INVALID_ARG;
+            }
+        }
+        group->servos[i] = servos[i];
+    }
+    group->num_servos = num_servos;
+
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks if the update loop of all servos in the group is running.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  True if all servos are up and running, false if not.
+ */
+bool pbio_motion_group_update_loop_is_running(pbio_motion_group_t *group) {
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        if (!pbio_servo_update_loop_is_running(group->servos[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if all servos in the group are done.
+ *
+ * @param [in]  group       The motion group instance.
+ * @return                  True if all servos are done, false if not.
+ */
+bool pbio_motion_group_is_done(const pbio_motion_group_t *group) {
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        if (!pbio_control_is_done(&group->servos[i]->control)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Starts position control of all servos in the group on the same control tick.
+ *
+ * @param [in]  group          The motion group instance.
+ * @param [in]  speeds         Top angular velocity of each servo in degrees per second, or NULL to use @p speed for all servos.
+ * @param [in]  speed          Top angular velocity of all servos if @p speeds is NULL.
+ * @param [in]  targets        Target angle of each servo, in the order of the servos in the group.
+ * @param [in]  on_completion  What to do after becoming stationary at the target angles.
+ * @param [in]  synchronize    Whether to stretch the trajectories so that all servos finish together.
+ * @return                     Error code.
+ */
+static pbio_error_t pbio_motion_group_start(pbio_motion_group_t *group, const int32_t *speeds, int32_t speed, const int32_t *targets, pbio_control_on_completion_t on_completion, bool synchronize) {
+
+    pbio_error_t err;
+
+    // Don't allow new user command if any update loop is not registered, so
+    // we don't start only some of the servos.
+    if (!pbio_motion_group_update_loop_is_running(group)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // Stop parent objects that use these motors, if any.
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        err = pbio_parent_stop(&group->servos[i]->parent, false);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+
+    // All trajectories start at the same time.
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    // Compute all trajectories first, keeping track of the one that takes the
+    // longest. If any of them fails, no servo has been started yet.
+    pbio_trajectory_t trajectories[PBIO_CONFIG_SERVO_NUM_DEV];
+    const pbio_trajectory_t *leader = NULL;
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        pbio_servo_t *srv = group->servos[i];
+
+        pbio_control_state_t state;
+        err = pbio_servo_get_state_control(srv, &state);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+        err = pbio_control_prepare_position_control(&srv->control, time_now, &state, targets[i], speeds ? speeds[i] : speed, on_completion, &trajectories[i]);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+
+        if (!leader || pbio_trajectory_get_duration(&trajectories[i]) > pbio_trajectory_get_duration(leader)) {
+            leader = &trajectories[i];
+        }
+    }
+
+    // Revise follower trajectories so they take as long as the leader,
+    // achieved by picking lower speeds and accelerations that makes the
+    // times match.
+    if (synchronize) {
+        for (uint8_t i = 0; i < group->num_servos; i++) {
+            if (&trajectories[i] != leader) {
+                pbio_trajectory_stretch(&trajectories[i], leader);
+            }
+        }
+    }
+
+    // Now start them all.
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        pbio_control_start_prepared_position_control(&group->servos[i]->control, time_now, &trajectories[i], on_completion);
+    }
+
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Runs all servos in the group to their target angles, such that they
+ * start and finish at the same time.
+ *
+ * All trajectories start on the same control tick. The servo that takes the
+ * longest leads, and the others are stretched to take equally long by
+ * lowering their speed and acceleration.
+ *
+ * @param [in]  group          The motion group instance.
+ * @param [in]  speed          Top angular velocity of each servo in degrees per second. The sign is ignored. If zero, the default speed of each servo is used.
+ * @param [in]  targets        Target angle of each servo, in the order of the servos in the group.
+ * @param [in]  on_completion  What to do after becoming stationary at the target angles.
+ * @return                     Error code.
+ */
+pbio_error_t pbio_motion_group_run_target(pbio_motion_group_t *group, int32_t speed, const int32_t *targets, pbio_control_on_completion_t on_completion) {
+    return pbio_motion_group_start(group, NULL, speed, targets, on_completion, true);
+}
+
+/**
+ * Runs each servo in the group to its own target angle at its own speed.
+ *
+ * All trajectories start on the same control tick, but each servo finishes
+ * according to its own speed and distance. This starts several servos with
+ * a single call, instead of one call per servo.
+ *
+ * @param [in]  group          The motion group instance.
+ * @param [in]  speeds         Top angular velocity of each servo in degrees per second. The sign is ignored. If zero, the default speed of that servo is used.
+ * @param [in]  targets        Target angle of each servo, in the order of the servos in the group.
+ * @param [in]  on_completion  What to do after becoming stationary at the target angles.
+ * @return                     Error code.
+ */
+pbio_error_t pbio_motion_group_run_targets(pbio_motion_group_t *group, const int32_t *speeds, const int32_t *targets, pbio_control_on_completion_t on_completion) {
+    return pbio_motion_group_start(group, speeds, 0, targets, on_completion, false);
+}
+
+/**
+ * Stops all servos in the group.
+ *
+ * @param [in]  group          The motion group instance.
+ * @param [in]  on_completion  Coast, brake, or hold after stopping the controller.
+ * @return                     Error code of the first servo that failed to stop, if any.
+ */
+pbio_error_t pbio_motion_group_stop(pbio_motion_group_t *group, pbio_control_on_completion_t on_completion) {
+
+    pbio_error_t result = PBIO_SUCCESS;
+
+    // Attempt to stop all of them, even if some fail.
+    for (uint8_t i = 0; i < group->num_servos; i++) {
+        pbio_error_t err = pbio_servo_stop(group->servos[i], on_completion);
+        if (result == PBIO_SUCCESS) {
+            result = err;
+        }
+    }
+    return result;
+}
+
+#endif // PBIO_CONFIG_MOTION_GROUP
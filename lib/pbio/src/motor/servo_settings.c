@@ -36,6 +36,18 @@ static const pbio_observer_model_t model_technic_s_angular = {
     .d_torque_d_speed = 12282,
     .d_torque_d_acceleration = 35129,
     .torque_friction = 9182,
+    .d_angle_d_speed_reciprocal = 80321,
+    .d_speed_d_speed_reciprocal = 15057376,
+    .d_current_d_speed_reciprocal = -57753,
+    .d_angle_d_current_reciprocal = 615774,
+    .d_speed_d_current_reciprocal = 156658841,
+    .d_current_d_current_reciprocal = -128361,
+    .d_angle_d_voltage_reciprocal = 530932,
+    .d_speed_d_voltage_reciprocal = 256570113,
+    .d_current_d_voltage_reciprocal = 8600230,
+    .d_angle_d_torque_reciprocal = -84570,
+    .d_speed_d_torque_reciprocal = -33198786,
+    .d_current_d_torque_reciprocal = 93822,
 };
 
 static const pbio_observer_model_t model_technic_m_angular = {
@@ -56,6 +68,18 @@ static const pbio_observer_model_t model_technic_m_angular = {
     .d_torque_d_speed = 5903,
     .d_torque_d_acceleration = 16163,
     .torque_friction = 21413,
+    .d_angle_d_speed_reciprocal = 81238,
+    .d_speed_d_speed_reciprocal = 15412046,
+    .d_current_d_speed_reciprocal = -87229,
+    .d_angle_d_current_reciprocal = 498866,
+    .d_speed_d_current_reciprocal = 144500863,
+    .d_current_d_current_reciprocal = 1135079,
+    .d_angle_d_voltage_reciprocal = 404006,
+    .d_speed_d_voltage_reciprocal = 207863713,
+    .d_current_d_voltage_reciprocal = 13307847,
+    .d_angle_d_torque_reciprocal = -39188,
+    .d_speed_d_torque_reciprocal = -15446262,
+    .d_current_d_torque_reciprocal = 57265,
 };
 
 static const pbio_observer_model_t model_technic_l_angular = {
@@ -76,6 +100,18 @@ static const pbio_observer_model_t model_technic_l_angular = {
     .d_torque_d_speed = 1919,
     .d_torque_d_acceleration = 3997,
     .torque_friction = 23239,
+    .d_angle_d_speed_reciprocal = 82283,
+    .d_speed_d_speed_reciprocal = 15923508,
+    .d_current_d_speed_reciprocal = -247995,
+    .d_angle_d_current_reciprocal = 143512,
+    .d_speed_d_current_reciprocal = 45305065,
+    .d_current_d_current_reciprocal = 3031438,
+    .d_angle_d_voltage_reciprocal = 223343,
+    .d_speed_d_voltage_reciprocal = 119593048,
+    .d_current_d_voltage_reciprocal = 34549867,
+    .d_angle_d_torque_reciprocal = -9760,
+    .d_speed_d_torque_reciprocal = -3869031,
+    .d_current_d_torque_reciprocal = 36939,
 };
 
 static const pbio_observer_model_t model_interactive = {
@@ -96,6 +132,18 @@ static const pbio_observer_model_t model_interactive = {
     .d_torque_d_speed = 10599,
     .d_torque_d_acceleration = 20588,
     .torque_friction = 11227,
+    .d_angle_d_speed_reciprocal = 80369,
+    .d_speed_d_speed_reciprocal = 15297398,
+    .d_current_d_speed_reciprocal = -45530,
+    .d_angle_d_current_reciprocal = 164259,
+    .d_speed_d_current_reciprocal = 33592914,
+    .d_current_d_current_reciprocal = -99957,
+    .d_angle_d_voltage_reciprocal = 652140,
+    .d_speed_d_voltage_reciprocal = 273765247,
+    .d_current_d_voltage_reciprocal = 8441629,
+    .d_angle_d_torque_reciprocal = -49448,
+    .d_speed_d_torque_reciprocal = -19470639,
+    .d_current_d_torque_reciprocal = 53923,
 };
 
 static const pbio_observer_model_t model_technic_l = {
@@ -116,6 +164,18 @@ static const pbio_observer_model_t model_technic_l = {
     .d_torque_d_speed = 6837,
     .d_torque_d_acceleration = 10751,
     .torque_friction = 26430,
+    .d_angle_d_speed_reciprocal = 81800,
+    .d_speed_d_speed_reciprocal = 15783828,
+    .d_current_d_speed_reciprocal = -90065,
+    .d_angle_d_current_reciprocal = 209662,
+    .d_speed_d_current_reciprocal = 52703150,
+    .d_current_d_current_reciprocal = -27200,
+    .d_angle_d_voltage_reciprocal = 487005,
+    .d_speed_d_voltage_reciprocal = 232959611,
+    .d_current_d_voltage_reciprocal = 21020973,
+    .d_angle_d_torque_reciprocal = -26146,
+    .d_speed_d_torque_reciprocal = -10344826,
+    .d_current_d_torque_reciprocal = 45317,
 };
 
 static const pbio_observer_model_t model_technic_xl = {
@@ -136,6 +196,18 @@ static const pbio_observer_model_t model_technic_xl = {
     .d_torque_d_speed = 7713,
     .d_torque_d_acceleration = 11578,
     .torque_friction = 12893,
+    .d_angle_d_speed_reciprocal = 81530,
+    .d_speed_d_speed_reciprocal = 15714903,
+    .d_current_d_speed_reciprocal = -82175,
+    .d_angle_d_current_reciprocal = 148296,
+    .d_speed_d_current_reciprocal = 33606074,
+    .d_current_d_current_reciprocal = -157892,
+    .d_angle_d_voltage_reciprocal = 548734,
+    .d_speed_d_voltage_reciprocal = 247150434,
+    .d_current_d_voltage_reciprocal = 19136748,
+    .d_angle_d_torque_reciprocal = -28084,
+    .d_speed_d_torque_reciprocal = -11103786,
+    .d_current_d_torque_reciprocal = 49392,
 };
 
 #if PBIO_CONFIG_SERVO_PUP_MOVE_HUB
@@ -158,6 +230,18 @@ static const pbio_observer_model_t model_movehub = {
     .d_torque_d_speed = 10851,
     .d_torque_d_acceleration = 15357,
     .torque_friction = 24835,
+    .d_angle_d_speed_reciprocal = 81658,
+    .d_speed_d_speed_reciprocal = 15766540,
+    .d_current_d_speed_reciprocal = -70969,
+    .d_angle_d_current_reciprocal = 161482,
+    .d_speed_d_current_reciprocal = 36606416,
+    .d_current_d_current_reciprocal = -147929,
+    .d_angle_d_voltage_reciprocal = 597736,
+    .d_speed_d_voltage_reciprocal = 269127238,
+    .d_current_d_voltage_reciprocal = 19036162,
+    .d_angle_d_torque_reciprocal = -37286,
+    .d_speed_d_torque_reciprocal = -14750484,
+    .d_current_d_torque_reciprocal = 56563,
 };
 
 #endif // PBIO_CONFIG_SERVO_PUP_MOVE_HUB
@@ -184,6 +268,18 @@ static const pbio_observer_model_t model_ev3_l = {
     .d_torque_d_speed = 2083,
     .d_torque_d_acceleration = 1965,
     .torque_friction = 16476,
+    .d_angle_d_speed_reciprocal = 163041,
+    .d_speed_d_speed_reciprocal = 15629589,
+    .d_current_d_speed_reciprocal = -233584,
+    .d_angle_d_current_reciprocal = 208669,
+    .d_speed_d_current_reciprocal = 26942762,
+    .d_current_d_current_reciprocal = 56282,
+    .d_angle_d_voltage_reciprocal = 572970,
+    .d_speed_d_voltage_reciprocal = 139115164,
+    .d_current_d_voltage_reciprocal = 28289677,
+    .d_angle_d_torque_reciprocal = -19084,
+    .d_speed_d_torque_reciprocal = -3769826,
+    .d_current_d_torque_reciprocal = 41829,
 };
 
 static const pbio_observer_model_t model_ev3_m = {
@@ -204,6 +300,18 @@ static const pbio_observer_model_t model_ev3_m = {
     .d_torque_d_speed = 7365,
     .d_torque_d_acceleration = 9355,
     .torque_friction = 18317,
+    .d_angle_d_speed_reciprocal = 159891,
+    .d_speed_d_speed_reciprocal = 15010273,
+    .d_current_d_speed_reciprocal = -77759,
+    .d_angle_d_current_reciprocal = 505029,
+    .d_speed_d_current_reciprocal = 56079695,
+    .d_current_d_current_reciprocal = -270951,
+    .d_angle_d_voltage_reciprocal = 1503841,
+    .d_speed_d_voltage_reciprocal = 336703316,
+    .d_current_d_voltage_reciprocal = 14836696,
+    .d_angle_d_torque_reciprocal = -89715,
+    .d_speed_d_torque_reciprocal = -17596816,
+    .d_current_d_torque_reciprocal = 77067,
 };
 
 #endif // PBIO_CONFIG_SERVO_EV3_NXT
@@ -1,20 +1,84 @@
 // SPDX-License-Identifier: MIT
 // Copyright (c) 2018-2023 The Pybricks Authors
 
+#include <stdbool.h>
+#include <string.h>
+
+#include <pbdrv/clock.h>
+
 #include <pbio/battery.h>
 #include <pbio/control.h>
 #include <pbio/drivebase.h>
+#include <pbio/motor_process.h>
 #include <pbio/servo.h>
 
 #include <contiki.h>
 
 #if PBIO_CONFIG_MOTOR_PROCESS != 0
 
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+static pbio_motor_process_stats_t stats;
+
+// Whether the start time of the previous update is known, needed for jitter.
+static bool stats_have_previous;
+
+/**
+ * Gets the timing statistics of the motor control loop.
+ *
+ * @return                  The statistics since boot or the last reset.
+ */
+const pbio_motor_process_stats_t *pbio_motor_process_get_stats(void) {
+    return &stats;
+}
+
+/**
+ * Resets the timing statistics of the motor control loop.
+ */
+void pbio_motor_process_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+    stats_have_previous = false;
+}
+
+static void pbio_motor_process_histogram_add(pbio_motor_process_histogram_t *histogram, uint32_t duration) {
+    uint8_t bin = 0;
+    while (bin < PBIO_MOTOR_PROCESS_STATS_NUM_BINS - 1 && duration >= (PBIO_MOTOR_PROCESS_STATS_BIN_US << bin)) {
+        bin++;
+    }
+    histogram->bins[bin]++;
+    if (duration > histogram->max) {
+        histogram->max = duration;
+    }
+}
+
+static void pbio_motor_process_stats_add_period(uint32_t time_now, uint32_t time_prev) {
+    if (stats_have_previous) {
+        int32_t jitter = (int32_t)(time_now - time_prev) - PBIO_CONFIG_CONTROL_LOOP_TIME_MS * 1000;
+        pbio_motor_process_histogram_add(&stats.jitter, jitter < 0 ? -jitter : jitter);
+    }
+    stats_have_previous = true;
+    stats.num_updates++;
+}
+
+#define STATS_TIME_START(name) uint32_t name = pbdrv_clock_get_us()
+#define STATS_TIME_END(name, histogram) pbio_motor_process_histogram_add(&stats.histogram, pbdrv_clock_get_us() - name)
+
+#else
+
+#define STATS_TIME_START(name)
+#define STATS_TIME_END(name, histogram)
+
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
 PROCESS(pbio_motor_process, "servo");
 
 PROCESS_THREAD(pbio_motor_process, ev, data) {
     static struct etimer timer;
 
+    #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+    static uint32_t time_prev;
+    #endif
+
     PROCESS_BEGIN();
 
     // Initialize battery voltage.
@@ -28,14 +92,26 @@ PROCESS_THREAD(pbio_motor_process, ev, data) {
     for (;;) {
         PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && etimer_expired(&timer));
 
+        #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+        uint32_t time_start = pbdrv_clock_get_us();
+        pbio_motor_process_stats_add_period(time_start, time_prev);
+        time_prev = time_start;
+        #endif
+
         // Update battery voltage.
+        STATS_TIME_START(time_battery);
         pbio_battery_update();
+        STATS_TIME_END(time_battery, battery);
 
         // Update drivebase
+        STATS_TIME_START(time_drivebase);
         pbio_drivebase_update_all();
+        STATS_TIME_END(time_drivebase, drivebase);
 
         // Update servos
+        STATS_TIME_START(time_servo);
         pbio_servo_update_all();
+        STATS_TIME_END(time_servo, servo);
 
         clock_time_t now = clock_time();
 
@@ -45,6 +121,9 @@ PROCESS_THREAD(pbio_motor_process, ev, data) {
         // diff which causes issues.
         if (now - etimer_start_time(&timer) >= 2 * PBIO_CONFIG_CONTROL_LOOP_TIME_MS) {
             timer.timer.start = now - (PBIO_CONFIG_CONTROL_LOOP_TIME_MS - 1);
+            #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+            stats.num_overruns++;
+            #endif
         }
 
         // Reset timer to wait for next update. Using etimer_reset() instead
@@ -15,18 +15,6 @@
 #include <pbio/observer.h>
 #include <pbio/trajectory.h>
 
-// Values generated by pbio/doc/control/model.py
-#define MAX_NUM_SPEED (2500000)
-#define MAX_NUM_ACCELERATION (25000000)
-#define MAX_NUM_CURRENT (30000)
-#define MAX_NUM_VOLTAGE (12000)
-#define MAX_NUM_TORQUE (1000000)
-#define PRESCALE_SPEED (858)
-#define PRESCALE_ACCELERATION (85)
-#define PRESCALE_CURRENT (71582)
-#define PRESCALE_VOLTAGE (178956)
-#define PRESCALE_TORQUE (2147)
-
 /**
  * Resets the observer to a new angle. Speed and current are reset to zero.
  *
@@ -138,7 +126,7 @@ int32_t pbio_observer_get_feedback_voltage(const pbio_observer_t *obs, const pbi
     int32_t feedback_voltage_abs = pbio_observer_get_feedback_voltage_abs(pbio_int_math_abs(error), &obs->settings);
 
     // Sign and clamp the feedback voltage.
-    return pbio_int_math_clamp(feedback_voltage_abs * pbio_int_math_sign(error), MAX_NUM_VOLTAGE);
+    return pbio_int_math_clamp(feedback_voltage_abs * pbio_int_math_sign(error), PBIO_OBSERVER_MAX_NUM_VOLTAGE);
 }
 
 /**
@@ -165,7 +153,7 @@ void pbio_observer_update(pbio_observer_t *obs, uint32_t time, const pbio_angle_
 
     // The observer will get the applied voltage plus the feedback voltage to
     // keep it in sync with the real system.
-    int32_t model_voltage = pbio_int_math_clamp(voltage + feedback_voltage, MAX_NUM_VOLTAGE);
+    int32_t model_voltage = pbio_int_math_clamp(voltage + feedback_voltage, PBIO_OBSERVER_MAX_NUM_VOLTAGE);
 
     // Modified coulomb friction with transition linear in speed through origin.
     int32_t coulomb_friction = pbio_int_math_sign(obs->speed) * (
@@ -182,25 +170,25 @@ void pbio_observer_update(pbio_observer_t *obs, uint32_t time, const pbio_angle_
     // mode is coast, back EMF is slightly overestimated, but an accurate
     // speed value is typically not needed in that use case.
     pbio_angle_add_mdeg(&obs->angle,
-        PRESCALE_SPEED * obs->speed / m->d_angle_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_angle_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_angle_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_angle_d_torque);
+        pbio_observer_model_scale(obs->speed, m->d_angle_d_speed_reciprocal) +
+        pbio_observer_model_scale(obs->current, m->d_angle_d_current_reciprocal) +
+        pbio_observer_model_scale(model_voltage, m->d_angle_d_voltage_reciprocal) +
+        pbio_observer_model_scale(torque, m->d_angle_d_torque_reciprocal));
     int32_t speed_next = pbio_int_math_clamp(0 +
-        PRESCALE_SPEED * obs->speed / m->d_speed_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_speed_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_speed_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_speed_d_torque, MAX_NUM_SPEED);
+        pbio_observer_model_scale(obs->speed, m->d_speed_d_speed_reciprocal) +
+        pbio_observer_model_scale(obs->current, m->d_speed_d_current_reciprocal) +
+        pbio_observer_model_scale(model_voltage, m->d_speed_d_voltage_reciprocal) +
+        pbio_observer_model_scale(torque, m->d_speed_d_torque_reciprocal), PBIO_OBSERVER_MAX_NUM_SPEED);
     int32_t current_next = pbio_int_math_clamp(0 +
-        PRESCALE_SPEED * obs->speed / m->d_current_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_current_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_current_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_current_d_torque, MAX_NUM_CURRENT);
+        pbio_observer_model_scale(obs->speed, m->d_current_d_speed_reciprocal) +
+        pbio_observer_model_scale(obs->current, m->d_current_d_current_reciprocal) +
+        pbio_observer_model_scale(model_voltage, m->d_current_d_voltage_reciprocal) +
+        pbio_observer_model_scale(torque, m->d_current_d_torque_reciprocal), PBIO_OBSERVER_MAX_NUM_CURRENT);
 
     // In case of a speed transition through zero, undo (subtract) the effect
     // of friction, to avoid inducing chatter in the speed signal.
     if ((obs->speed < 0) != (speed_next < 0)) {
-        speed_next -= PRESCALE_TORQUE * coulomb_friction / m->d_speed_d_torque;
+        speed_next -= pbio_observer_model_scale(coulomb_friction, m->d_speed_d_torque_reciprocal);
     }
 
     // Save new state.
@@ -234,7 +222,7 @@ bool pbio_observer_is_stalled(const pbio_observer_t *obs, uint32_t time, uint32_
  *
 */
 int32_t pbio_observer_get_max_torque(void) {
-    return MAX_NUM_TORQUE;
+    return PBIO_OBSERVER_MAX_NUM_TORQUE;
 }
 
 /**
@@ -250,11 +238,11 @@ int32_t pbio_observer_get_max_torque(void) {
 int32_t pbio_observer_get_feedforward_torque(const pbio_observer_model_t *model, int32_t rate_ref, int32_t acceleration_ref) {
 
     int32_t friction_compensation_torque = model->torque_friction / 2 * pbio_int_math_sign(rate_ref);
-    int32_t back_emf_compensation_torque = PRESCALE_SPEED * pbio_int_math_clamp(rate_ref, MAX_NUM_SPEED) / model->d_torque_d_speed;
-    int32_t acceleration_torque = PRESCALE_ACCELERATION * pbio_int_math_clamp(acceleration_ref, MAX_NUM_ACCELERATION) / model->d_torque_d_acceleration;
+    int32_t back_emf_compensation_torque = PBIO_OBSERVER_PRESCALE_SPEED * pbio_int_math_clamp(rate_ref, PBIO_OBSERVER_MAX_NUM_SPEED) / model->d_torque_d_speed;
+    int32_t acceleration_torque = PBIO_OBSERVER_PRESCALE_ACCELERATION * pbio_int_math_clamp(acceleration_ref, PBIO_OBSERVER_MAX_NUM_ACCELERATION) / model->d_torque_d_acceleration;
 
     // Total feedforward torque
-    return pbio_int_math_clamp(friction_compensation_torque + back_emf_compensation_torque + acceleration_torque, MAX_NUM_TORQUE);
+    return pbio_int_math_clamp(friction_compensation_torque + back_emf_compensation_torque + acceleration_torque, PBIO_OBSERVER_MAX_NUM_TORQUE);
 }
 
 /**
@@ -265,7 +253,7 @@ int32_t pbio_observer_get_feedforward_torque(const pbio_observer_model_t *model,
  * @returns                         The voltage in mV.
 */
 int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int32_t desired_torque) {
-    return PRESCALE_TORQUE * pbio_int_math_clamp(desired_torque, MAX_NUM_TORQUE) / model->d_voltage_d_torque;
+    return PBIO_OBSERVER_PRESCALE_TORQUE * pbio_int_math_clamp(desired_torque, PBIO_OBSERVER_MAX_NUM_TORQUE) / model->d_voltage_d_torque;
 }
 
 /**
@@ -276,5 +264,5 @@ int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int3
  * @returns                         The torque in uNm.
 */
 int32_t pbio_observer_voltage_to_torque(const pbio_observer_model_t *model, int32_t voltage) {
-    return PRESCALE_VOLTAGE * pbio_int_math_clamp(voltage, MAX_NUM_VOLTAGE) / model->d_torque_d_voltage;
+    return PBIO_OBSERVER_PRESCALE_VOLTAGE * pbio_int_math_clamp(voltage, PBIO_OBSERVER_MAX_NUM_VOLTAGE) / model->d_torque_d_voltage;
 }
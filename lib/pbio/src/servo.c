@@ -73,17 +73,23 @@ bool pbio_servo_update_loop_is_running(pbio_servo_t *srv) {
     return srv->run_update_loop;
 }
 
-static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
-
-    // Get current time
-    uint32_t time_now = pbio_control_get_time_ticks();
+/**
+ * Updates the servo controller, logger, and observer for a measured angle.
+ *
+ * This is the servo update without reading the tacho, so it can also be used
+ * to replay angles recorded on a hub.
+ *
+ * @param [in]  srv         The servo instance.
+ * @param [in]  time_now    Time (ticks) of the measurement.
+ * @param [in]  angle       Measured angle in units of control.
+ * @return                  Error code.
+ */
+pbio_error_t pbio_servo_update_with_angle(pbio_servo_t *srv, uint32_t time_now, const pbio_angle_t *angle) {
 
-    // Read the physical and estimated state
+    // Combine the physical angle with the estimated state
     pbio_control_state_t state;
-    pbio_error_t err = pbio_servo_get_state_control(srv, &state);
-    if (err != PBIO_SUCCESS) {
-        return err;
-    }
+    state.position = *angle;
+    pbio_observer_get_estimated_state(&srv->observer, &state.speed, &state.position_estimate, &state.speed_estimate);
 
     // Trajectory reference point
     pbio_trajectory_reference_t ref;
@@ -92,8 +98,18 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
     int32_t feedback_torque = 0;
     int32_t feedforward_torque = 0;
 
+    // Servos that are done and holding position don't need a controller
+    // update on every loop, so they may be updated less frequently.
+    srv->update_count++;
+    bool idle = pbio_control_is_done(&srv->control) && srv->control.on_completion != PBIO_CONTROL_ON_COMPLETION_CONTINUE;
+    bool update_control = !idle || srv->update_count >= srv->update_divisor;
+    if (update_control) {
+        srv->control.update_interval = srv->update_count;
+        srv->update_count = 0;
+    }
+
     // Check if a control update is needed
-    if (pbio_control_is_active(&srv->control)) {
+    if (update_control && pbio_control_is_active(&srv->control)) {
 
         // Calculate feedback control signal
         pbio_dcmotor_actuation_t requested_actuation;
@@ -112,7 +128,7 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
         int32_t total_torque = pbio_int_math_clamp(feedback_torque + feedforward_torque, srv->control.settings.actuation_max_temporary);
 
         // Actuate the servo. For torque control, the torque payload is passed along. Otherwise payload is ignored.
-        err = pbio_servo_actuate(srv, requested_actuation, total_torque);
+        pbio_error_t err = pbio_servo_actuate(srv, requested_actuation, total_torque);
         if (err != PBIO_SUCCESS) {
             return err;
         }
@@ -122,46 +138,77 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
     int32_t voltage;
     pbio_dcmotor_get_state(srv->dcmotor, &applied_actuation, &voltage);
 
-    // Optionally log servo state.
-    if (pbio_logger_is_active(&srv->log)) {
-
-        // Get stall state
-        bool stalled;
-        uint32_t stall_duration;
-        pbio_servo_is_stalled(srv, &stalled, &stall_duration);
-
-        int32_t log_data[] = {
-            // Column 0: Log time (added by logger).
-            // Column 1: Current time.
-            time_now,
-            // Column 2: Motor angle in degrees.
-            pbio_control_settings_ctl_to_app_long(&srv->control.settings, &state.position),
-            // Column 3: Motor speed in degrees/second.
-            pbio_control_settings_ctl_to_app(&srv->control.settings, state.speed),
-            // Column 4: Actuation type (LSB 0--1), stall state (LSB 2).
-            applied_actuation | ((int32_t)stalled << 2),
-            // Column 5: Actuation voltage.
-            voltage,
-            // Column 6: Estimated position in degrees.
-            pbio_control_settings_ctl_to_app_long(&srv->control.settings, &state.position_estimate),
-            // Column 7: Estimated speed in degrees/second.
-            pbio_control_settings_ctl_to_app(&srv->control.settings, state.speed_estimate),
-            // Column 8: Feedback torque (uNm).
-            feedback_torque,
-            // Column 9: Feedforward torque (uNm).
-            feedforward_torque,
-            // Column 10: Observer error feedback voltage torque (mV).
-            pbio_observer_get_feedback_voltage(&srv->observer, &state.position),
-        };
-        pbio_logger_add_row(&srv->log, log_data);
-    }
-
-    // Update the state observer
+    // Optionally log servo state. Only values selected by the log columns
+    // are computed, since some of them are relatively expensive. This is
+    // done on every loop, so rows stay evenly spaced in time.
+    pbio_log_t *log = &srv->log;
+    if (pbio_logger_is_active(log)) {
+
+        int32_t log_data[PBIO_SERVO_LOGGER_NUM_COLS] = { 0 };
+
+        // Column 0: Log time (added by logger).
+        // Column 1: Current time.
+        log_data[0] = time_now;
+        // Column 2: Motor angle in degrees.
+        if (pbio_logger_column_is_enabled(log, 1)) {
+            log_data[1] = pbio_control_settings_ctl_to_app_long(&srv->control.settings, &state.position);
+        }
+        // Column 3: Motor speed in degrees/second.
+        if (pbio_logger_column_is_enabled(log, 2)) {
+            log_data[2] = pbio_control_settings_ctl_to_app(&srv->control.settings, state.speed);
+        }
+        // Column 4: Actuation type (LSB 0--1), stall state (LSB 2).
+        if (pbio_logger_column_is_enabled(log, 3)) {
+            bool stalled;
+            uint32_t stall_duration;
+            pbio_servo_is_stalled(srv, &stalled, &stall_duration);
+            log_data[3] = applied_actuation | ((int32_t)stalled << 2);
+        }
+        // Column 5: Actuation voltage.
+        log_data[4] = voltage;
+        // Column 6: Estimated position in degrees.
+        if (pbio_logger_column_is_enabled(log, 5)) {
+            log_data[5] = pbio_control_settings_ctl_to_app_long(&srv->control.settings, &state.position_estimate);
+        }
+        // Column 7: Estimated speed in degrees/second.
+        if (pbio_logger_column_is_enabled(log, 6)) {
+            log_data[6] = pbio_control_settings_ctl_to_app(&srv->control.settings, state.speed_estimate);
+        }
+        // Column 8: Feedback torque (uNm). This and the feedforward torque
+        // are zero on loops without a controller update.
+        log_data[7] = feedback_torque;
+        // Column 9: Feedforward torque (uNm).
+        log_data[8] = feedforward_torque;
+        // Column 10: Observer error feedback voltage torque (mV).
+        if (pbio_logger_column_is_enabled(log, 9)) {
+            log_data[9] = pbio_observer_get_feedback_voltage(&srv->observer, &state.position);
+        }
+        pbio_logger_add_row(log, log_data);
+    }
+
+    // Update the state observer. This is done on every loop, even if the
+    // controller was not updated, since the observer model is discretized
+    // at the control loop time.
     pbio_observer_update(&srv->observer, time_now, &state.position, applied_actuation, voltage);
 
     return PBIO_SUCCESS;
 }
 
+static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
+
+    // Get current time
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    // Read the physical angle
+    pbio_angle_t angle;
+    pbio_error_t err = pbio_tacho_get_angle(srv->tacho, &angle);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    return pbio_servo_update_with_angle(srv, time_now, &angle);
+}
+
 /**
  * Updates the servo state and controller.
  *
@@ -279,6 +326,8 @@ static pbio_error_t pbio_servo_initialize_settings(pbio_servo_t *srv, pbdrv_lego
         .position_tolerance = DEG_TO_MDEG(precision_profile),
         .acceleration = DEG_TO_MDEG(2000),
         .deceleration = DEG_TO_MDEG(2000),
+        // Constant acceleration phases by default.
+        .jerk_time = 0,
         .actuation_max = pbio_observer_voltage_to_torque(srv->observer.model, max_voltage),
         .actuation_max_temporary = pbio_observer_voltage_to_torque(srv->observer.model, max_voltage),
         // The nominal voltage is an indication for the nominal torque limit. To
@@ -350,6 +399,8 @@ pbio_error_t pbio_servo_setup(pbio_servo_t *srv, pbdrv_legodev_type_id_t type, p
 
     // Reset state
     pbio_control_reset(&srv->control);
+    srv->update_divisor = PBIO_CONFIG_SERVO_UPDATE_DIVISOR_IDLE;
+    srv->update_count = 0;
 
     // Load default settings for this device type.
     err = pbio_servo_initialize_settings(srv, type, gear_ratio, precision_profile);
@@ -374,6 +425,36 @@ pbio_error_t pbio_servo_setup(pbio_servo_t *srv, pbdrv_legodev_type_id_t type, p
     return PBIO_SUCCESS;
 }
 
+/**
+ * Sets how often the controller of an idle servo is updated.
+ *
+ * A servo is idle when it is done with its maneuver, so it is either holding
+ * position or passively stopped. Updating these less frequently frees up
+ * processing time for other tasks. Servos that are moving are always updated
+ * on every control loop.
+ *
+ * @param [in]  srv          The servo instance.
+ * @param [in]  divisor      Number of control loops between updates of an idle servo.
+ * @return                   ::PBIO_ERROR_INVALID_ARG if the divisor is out of range, otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbio_servo_set_update_divisor(pbio_servo_t *srv, uint8_t divisor) {
+    if (divisor < 1 || divisor > PBIO_SERVO_UPDATE_DIVISOR_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+    srv->update_divisor = divisor;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Gets how often the controller of an idle servo is updated.
+ *
+ * @param [in]  srv          The servo instance.
+ * @return                   Number of control loops between updates of an idle servo.
+ */
+uint8_t pbio_servo_get_update_divisor(const pbio_servo_t *srv) {
+    return srv->update_divisor;
+}
+
 /**
  * Resets the servo angle to a given value.
  *
@@ -725,7 +806,47 @@ pbio_error_t pbio_servo_run_target(pbio_servo_t *srv, int32_t speed, int32_t tar
     }
 
 
-    return pbio_control_start_position_control(&srv->control, time_now, &state, target, speed, on_completion);
+    return pbio_control_start_position_control(&srv->control, time_now, &state, target, speed, on_completion, true);
+}
+
+/**
+ * Queues a target angle to run to after the ongoing maneuver.
+ *
+ * If the servo is not running to a target, this is the same as
+ * pbio_servo_run_target. Otherwise, the servo runs to the given angle when
+ * the ongoing maneuver and any previously queued targets are complete,
+ * without decelerating in between if it keeps going in the same direction.
+ *
+ * @param [in]  srv            The control instance.
+ * @param [in]  speed          Top angular velocity in degrees per second. If zero, the default speed is used.
+ * @param [in]  target         Angle to run to.
+ * @param [in]  on_completion  What to do after becoming stationary at the target angle, if no other targets follow.
+ * @return                     Error code.
+ */
+pbio_error_t pbio_servo_queue_target(pbio_servo_t *srv, int32_t speed, int32_t target, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_servo_update_loop_is_running(srv)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // Stop parent object that uses this motor, if any.
+    pbio_error_t err = pbio_parent_stop(&srv->parent, false);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Get current time
+    uint32_t time_now = pbio_control_get_time_ticks();
+
+    // Read the physical and estimated state
+    pbio_control_state_t state;
+    err = pbio_servo_get_state_control(srv, &state);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    return pbio_control_queue_position_control(&srv->control, time_now, &state, target, speed, on_completion);
 }
 
 /**
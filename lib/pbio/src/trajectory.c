@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <pbio/angle.h>
 #include <pbio/int_math.h>
@@ -53,6 +54,12 @@
 #define assert_time(t) (assert((t) >= 0 && (t) < TIME_MAX))
 #define assert_accel_time(t) (assert((t) >= 0 && (t) < TIME_ACCEL_MAX))
 
+/*
+ * The time to ramp up the acceleration in jerk-limited trajectories is
+ * capped so the product with any acceleration time stays numerically bounded.
+ */
+#define JERK_TIME_MAX (PBIO_TRAJECTORY_JERK_TIME_MAX_MS * PBIO_TRAJECTORY_TICKS_PER_MS)
+
 /*
  * Position (mdeg) and time (1e-4 s) are the same as in control module.
  * But speed is in millidegrees/second in control units, but this module uses
@@ -156,6 +163,20 @@ pbio_error_t pbio_trajectory_validate_acceleration_limit(int32_t ctl_steps_per_a
     return PBIO_SUCCESS;
 }
 
+/**
+ * Validates that the given jerk time is within the numerically allowed range.
+ *
+ * @param [in] jerk_time                Time to ramp up the acceleration (ticks).
+ * @return                              ::PBIO_SUCCESS on valid values.
+ *                                      ::PBIO_ERROR_INVALID_ARG if the value is outside the allowed range.
+ */
+pbio_error_t pbio_trajectory_validate_jerk_time(uint32_t jerk_time) {
+    if (jerk_time > JERK_TIME_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+    return PBIO_SUCCESS;
+}
+
 /**
  * Reverses a trajectory.
  *
@@ -397,6 +418,188 @@ static int32_t intersect_ramp(int32_t th3, int32_t th0, int32_t a0, int32_t a2)
     return th0 + pbio_int_math_mult_then_div(th3 - th0, a2, a2 - a0);
 }
 
+/**
+ * Gets the duration and ramp time of a jerk-limited acceleration phase.
+ *
+ * The acceleration ramps linearly up to @p a in @p jerk_time, stays there,
+ * and ramps back down in the same amount of time. This takes @p jerk_time
+ * longer than the same speed change with constant acceleration. If the speed
+ * change is too small to reach @p a, the acceleration ramps up and down
+ * without a constant phase, at the same rate of change.
+ *
+ * @param [in]  w_start     The starting speed in ddeg/s.
+ * @param [in]  w_end       The ending speed in ddeg/s.
+ * @param [in]  a           The acceleration magnitude in deg/s^2.
+ * @param [in]  jerk_time   The time to ramp up to @p a in s*10^-4.
+ * @param [out] duration    The duration of the phase in s*10^-4.
+ * @param [out] ramp_time   The time to ramp the acceleration up or down in s*10^-4.
+ */
+static void get_jerk_limited_phase(int32_t w_start, int32_t w_end, int32_t a, int32_t jerk_time, int32_t *duration, int32_t *ramp_time) {
+
+    // Duration of the phase if it had constant acceleration.
+    int32_t t = div_w_by_a(pbio_int_math_abs(w_end - w_start), a);
+
+    if (t == 0) {
+        *duration = 0;
+        *ramp_time = 0;
+    } else if (t >= jerk_time) {
+        *duration = t + jerk_time;
+        *ramp_time = jerk_time;
+    } else {
+        // Equal jerk means the ramp time scales with the square root of the
+        // speed change. Since t < jerk_time, the product is small.
+        *ramp_time = pbio_int_math_sqrt(t * jerk_time);
+        *duration = *ramp_time * 2;
+    }
+}
+
+/**
+ * Gets the angle traversed during an acceleration phase.
+ *
+ * Jerk-limited phases are symmetric, so just like phases with constant
+ * acceleration, the angle is the average speed times the duration.
+ *
+ * @param [in]  w_start     The starting speed in ddeg/s.
+ * @param [in]  w_end       The ending speed in ddeg/s.
+ * @param [in]  duration    The duration of the phase in s*10^-4.
+ * @returns                 The angle in mdeg.
+ */
+static int32_t get_phase_angle(int32_t w_start, int32_t w_end, int32_t duration) {
+    return mul_w_by_t(w_start + w_end, duration) / 2;
+}
+
+/**
+ * Replaces the constant acceleration phases of a forward trajectory by
+ * jerk-limited phases with the given peak speed.
+ *
+ * @param [in, out] trj             The trajectory to modify.
+ * @param [in]  w1                  Peak speed in ddeg/s.
+ * @param [in]  a0                  Acceleration magnitude during in-phase in deg/s^2.
+ * @param [in]  a2                  Acceleration magnitude during out-phase in deg/s^2.
+ * @param [in]  jerk_time           The time to ramp up the acceleration in s*10^-4.
+ * @param [in]  w3_is_w1            Whether the final speed is equal to the peak speed.
+ * @param [in]  fixed_duration      Whether to keep the duration (true) or the angle (false).
+ * @returns                         True if the phases fit within the trajectory, else false.
+ */
+static bool pbio_trajectory_set_jerk_limited_phases(pbio_trajectory_t *trj, int32_t w1, int32_t a0, int32_t a2, int32_t jerk_time, bool w3_is_w1, bool fixed_duration) {
+
+    int32_t w3 = w3_is_w1 ? w1 : trj->w3;
+
+    int32_t t1, tj0, t3mt2, tj2;
+    get_jerk_limited_phase(trj->w0, w1, a0, jerk_time, &t1, &tj0);
+    get_jerk_limited_phase(w1, w3, a2, jerk_time, &t3mt2, &tj2);
+
+    int32_t th1 = get_phase_angle(trj->w0, w1, t1);
+    int32_t th3mth2 = get_phase_angle(w1, w3, t3mt2);
+
+    // The constant speed phase takes up whatever remains.
+    int32_t t2mt1;
+    if (fixed_duration) {
+        t2mt1 = trj->t3 - t1 - t3mt2;
+        if (t2mt1 < 0) {
+            return false;
+        }
+        trj->th2 = th1 + mul_w_by_t(w1, t2mt1);
+        trj->th3 = trj->th2 + th3mth2;
+    } else {
+        int32_t th2mth1 = trj->th3 - th1 - th3mth2;
+        if (th2mth1 < 0 || (th2mth1 > 0 && w1 <= 0)) {
+            return false;
+        }
+        t2mt1 = th2mth1 == 0 ? 0 : div_th_by_w(th2mth1, w1);
+        if (t2mt1 > TIME_MAX - t1 - t3mt2) {
+            return false;
+        }
+        trj->th2 = trj->th3 - th3mth2;
+        trj->t3 = t1 + t2mt1 + t3mt2;
+    }
+
+    trj->w1 = w1;
+    trj->w3 = w3;
+    trj->th1 = th1;
+    trj->t1 = t1;
+    trj->t2 = t1 + t2mt1;
+    trj->tj0 = tj0;
+    trj->tj2 = tj2;
+
+    // Peak accelerations that give the required speed changes, bounded to
+    // undo rounding errors in the phase durations.
+    trj->a0 = t1 == 0 ? 0 : pbio_int_math_clamp(div_w_by_t(w1 - trj->w0, t1 - tj0), a0);
+    trj->a2 = t3mt2 == 0 ? 0 : pbio_int_math_clamp(div_w_by_t(w3 - w1, t3mt2 - tj2), a2);
+
+    // As with constant acceleration, skip negligible speed changes.
+    if (trj->t1 == 0) {
+        trj->w0 = trj->w1;
+    }
+    return true;
+}
+
+/**
+ * Converts a forward trajectory with constant acceleration phases into one
+ * with jerk-limited acceleration phases.
+ *
+ * The acceleration phases take longer this way, which is compensated by a
+ * shorter constant speed phase. If that is not long enough, the peak speed
+ * is reduced. If that does not help either, a shorter jerk time is used.
+ * Trajectories that start with too much speed to slow down in time are left
+ * with constant acceleration phases.
+ *
+ * @param [in, out] trj             An initialized forward trajectory to be modified.
+ * @param [in]  jerk_time           The time to ramp up the acceleration in s*10^-4.
+ * @param [in]  fixed_duration      Whether to keep the duration (true) or the angle (false).
+ */
+static void pbio_trajectory_make_jerk_limited(pbio_trajectory_t *trj, int32_t jerk_time, bool fixed_duration) {
+
+    // The phases computed so far have constant acceleration.
+    trj->tj0 = 0;
+    trj->tj2 = 0;
+
+    // Nothing more to do for constant acceleration or stationary maneuvers.
+    if (jerk_time == 0 || trj->t3 == 0) {
+        return;
+    }
+
+    const pbio_trajectory_t trapezoid = *trj;
+    const int32_t a0 = pbio_int_math_abs(trj->a0);
+    const int32_t a2 = pbio_int_math_abs(trj->a2);
+    const int32_t w1 = trj->w1;
+
+    // If the final speed equals the peak speed, it changes along with it.
+    const bool w3_is_w1 = trj->w3 == trj->w1 && trj->t3 == trj->t2;
+
+    // The peak speed can only be lowered down to the initial and final speed.
+    const int32_t w_lo = pbio_int_math_max(pbio_int_math_max(trj->w0, w3_is_w1 ? 0 : trj->w3), 0);
+
+    for (jerk_time = pbio_int_math_min(jerk_time, JERK_TIME_MAX); jerk_time > 0; jerk_time /= 2) {
+
+        // Use the original peak speed if possible.
+        *trj = trapezoid;
+        if (pbio_trajectory_set_jerk_limited_phases(trj, w1, a0, a2, jerk_time, w3_is_w1, fixed_duration)) {
+            return;
+        }
+
+        // Otherwise find the highest peak speed for which the phases fit.
+        int32_t lo = w_lo;
+        int32_t hi = w1;
+        while (hi - lo > 1) {
+            int32_t mid = lo + (hi - lo) / 2;
+            *trj = trapezoid;
+            if (pbio_trajectory_set_jerk_limited_phases(trj, mid, a0, a2, jerk_time, w3_is_w1, fixed_duration)) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        *trj = trapezoid;
+        if (lo > w_lo && pbio_trajectory_set_jerk_limited_phases(trj, lo, a0, a2, jerk_time, w3_is_w1, fixed_duration)) {
+            return;
+        }
+    }
+
+    // No jerk-limited solution, so keep constant acceleration.
+    *trj = trapezoid;
+}
+
 /**
  * Computes a trajectory for a timed command assuming *positive* speed.
  *
@@ -514,6 +717,9 @@ static pbio_error_t pbio_trajectory_new_forward_time_command(pbio_trajectory_t *
     if (trj->t1 < 0 || trj->t2 - trj->t1 < 0 || trj->t3 - trj->t2 < 0) {
         return PBIO_ERROR_FAILED;
     }
+
+    // Smoothen the acceleration phases if requested.
+    pbio_trajectory_make_jerk_limited(trj, c->jerk_time, true);
     return PBIO_SUCCESS;
 }
 
@@ -668,6 +874,9 @@ static pbio_error_t pbio_trajectory_new_forward_angle_command(pbio_trajectory_t
     if (trj->t1 < 0 || trj->t2 - trj->t1 < 0 || trj->t3 - trj->t2 < 0) {
         return PBIO_ERROR_FAILED;
     }
+
+    // Smoothen the acceleration phases if requested.
+    pbio_trajectory_make_jerk_limited(trj, c->jerk_time, false);
     return PBIO_SUCCESS;
 }
 
@@ -698,9 +907,12 @@ void pbio_trajectory_stretch(pbio_trajectory_t *trj, const pbio_trajectory_t *le
     trj->w1 = div_th_by_t(2 * trj->th3 - mul_w_by_t(trj->w0, trj->t1) - mul_w_by_t(trj->w3, trj->t3 - trj->t2),
         trj->t3 + trj->t2 - trj->t1);
 
-    // Get corresponding accelerations
-    trj->a0 = trj->t1 == 0 ? 0 : div_w_by_t(trj->w1 - trj->w0, trj->t1);
-    trj->a2 = (trj->t3 - trj->t2) == 0 ? 0 : div_w_by_t(trj->w3 - trj->w1, trj->t3 - trj->t2);
+    // Get corresponding accelerations. Jerk-limited phases have the same
+    // average speed, so only the peak acceleration differs.
+    trj->tj0 = leader->tj0;
+    trj->tj2 = leader->tj2;
+    trj->a0 = trj->t1 == 0 ? 0 : div_w_by_t(trj->w1 - trj->w0, trj->t1 - trj->tj0);
+    trj->a2 = (trj->t3 - trj->t2) == 0 ? 0 : div_w_by_t(trj->w3 - trj->w1, trj->t3 - trj->t2 - trj->tj2);
 
     // Since the target speed may have been lowered, we need to adjust w3 too.
     trj->w3 = (trj->t3 - trj->t2) == 0 ? trj->w1 : 0;
@@ -708,7 +920,9 @@ void pbio_trajectory_stretch(pbio_trajectory_t *trj, const pbio_trajectory_t *le
     // With all constraints already satisfied, we can just compute the
     // intermediate positions relative to the endpoints, given the now-known
     // accelerations and speeds.
-    trj->th1 = mul_w_by_t(trj->w0, trj->t1) + mul_a_by_t2(trj->a0, trj->t1);
+    trj->th1 = trj->tj0 == 0 ?
+        mul_w_by_t(trj->w0, trj->t1) + mul_a_by_t2(trj->a0, trj->t1) :
+        get_phase_angle(trj->w0, trj->w1, trj->t1);
     trj->th2 = trj->th1 + mul_w_by_t(trj->w1, trj->t2 - trj->t1);
 }
 
@@ -759,6 +973,97 @@ pbio_error_t pbio_trajectory_new_time_command(pbio_trajectory_t *trj, const pbio
     return PBIO_SUCCESS;
 }
 
+#if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
+/**
+ * Command parameters that fully determine the shape of an angle trajectory
+ * that starts at zero speed. The start time and position are just an offset.
+ */
+typedef struct _pbio_trajectory_cache_key_t {
+    int32_t distance;
+    int32_t speed_target;
+    int32_t acceleration;
+    int32_t deceleration;
+    uint32_t jerk_time;
+    bool continue_running;
+} pbio_trajectory_cache_key_t;
+
+/**
+ * Solved trajectory along with the command that produced it.
+ */
+typedef struct _pbio_trajectory_cache_entry_t {
+    pbio_trajectory_cache_key_t key;
+    pbio_trajectory_t trajectory;
+    bool valid;
+} pbio_trajectory_cache_entry_t;
+
+static struct {
+    pbio_trajectory_cache_entry_t entries[PBIO_CONFIG_TRAJECTORY_CACHE_SIZE];
+    uint8_t next;
+    uint32_t hits;
+    uint32_t misses;
+} cache;
+
+/**
+ * Gets the number of angle commands that were and were not found in the cache.
+ *
+ * @param [out] hits        Number of commands served from the cache.
+ * @param [out] misses      Number of cacheable commands that had to be solved.
+ */
+void pbio_trajectory_get_cache_stats(uint32_t *hits, uint32_t *misses) {
+    *hits = cache.hits;
+    *misses = cache.misses;
+}
+
+/**
+ * Clears all cached trajectories and statistics.
+ */
+void pbio_trajectory_reset_cache(void) {
+    memset(&cache, 0, sizeof(cache));
+}
+
+/**
+ * Looks up a solved trajectory with the given shape.
+ *
+ * @param [in]  key     The command parameters.
+ * @param [out] trj     The cached trajectory, if found.
+ * @returns             True if found, else false.
+ */
+static bool pbio_trajectory_cache_lookup(const pbio_trajectory_cache_key_t *key, pbio_trajectory_t *trj) {
+    for (uint8_t i = 0; i < PBIO_CONFIG_TRAJECTORY_CACHE_SIZE; i++) {
+        pbio_trajectory_cache_entry_t *entry = &cache.entries[i];
+        if (entry->valid &&
+            entry->key.distance == key->distance &&
+            entry->key.speed_target == key->speed_target &&
+            entry->key.acceleration == key->acceleration &&
+            entry->key.deceleration == key->deceleration &&
+            entry->key.jerk_time == key->jerk_time &&
+            entry->key.continue_running == key->continue_running) {
+            *trj = entry->trajectory;
+            cache.hits++;
+            return true;
+        }
+    }
+    cache.misses++;
+    return false;
+}
+
+/**
+ * Stores a solved trajectory, replacing the oldest entry if the cache is full.
+ *
+ * @param [in]  key     The command parameters.
+ * @param [in]  trj     The solved trajectory.
+ */
+static void pbio_trajectory_cache_store(const pbio_trajectory_cache_key_t *key, const pbio_trajectory_t *trj) {
+    pbio_trajectory_cache_entry_t *entry = &cache.entries[cache.next];
+    entry->key = *key;
+    entry->trajectory = *trj;
+    entry->valid = true;
+    cache.next = (cache.next + 1) % PBIO_CONFIG_TRAJECTORY_CACHE_SIZE;
+}
+
+#endif // PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
 /**
  * Computes a trajectory for an angle command.
  *
@@ -799,6 +1104,25 @@ pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbi
     // Bind target speed by maximum speed.
     c.speed_target = pbio_int_math_min(c.speed_target, c.speed_max);
 
+    #if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+    // Maneuvers from standstill are often repeated with the same parameters,
+    // so reuse the previous solution if there is one. Only the starting point
+    // differs, which is not part of the solution.
+    bool cacheable = c.speed_start == 0;
+    pbio_trajectory_cache_key_t key = {
+        .distance = distance,
+        .speed_target = c.speed_target,
+        .acceleration = c.acceleration,
+        .deceleration = c.deceleration,
+        .jerk_time = c.jerk_time,
+        .continue_running = c.continue_running,
+    };
+    if (cacheable && pbio_trajectory_cache_lookup(&key, trj)) {
+        pbio_trajectory_set_start(&trj->start, command);
+        return PBIO_SUCCESS;
+    }
+    #endif // PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
     // Check if the original user-specified maneuver is backward.
     bool backward = distance < 0;
 
@@ -820,6 +1144,12 @@ pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbi
         reverse_trajectory(trj);
     }
 
+    #if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+    if (cacheable) {
+        pbio_trajectory_cache_store(&key, trj);
+    }
+    #endif // PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
     return PBIO_SUCCESS;
 }
 
@@ -913,6 +1243,50 @@ uint32_t pbio_trajectory_get_duration(const pbio_trajectory_t *trj) {
     return TO_CONTROL_TIME(trj->t3);
 }
 
+/**
+ * Gets the reference within an acceleration phase, relative to its start.
+ *
+ * @param [in]  time        Time since the start of the phase in s*10^-4.
+ * @param [in]  duration    Duration of the phase in s*10^-4.
+ * @param [in]  ramp_time   Time to ramp the acceleration up or down in s*10^-4, or 0 if constant.
+ * @param [in]  w_start     Speed at the start of the phase in ddeg/s.
+ * @param [in]  w_end       Speed at the end of the phase in ddeg/s.
+ * @param [in]  a_peak      Acceleration (at its peak) in deg/s^2.
+ * @param [out] th          Angle traveled since the start of the phase in mdeg.
+ * @param [out] w           Speed in ddeg/s.
+ * @param [out] a           Acceleration in deg/s^2.
+ */
+static void get_phase_reference(int32_t time, int32_t duration, int32_t ramp_time, int32_t w_start, int32_t w_end, int32_t a_peak, int32_t *th, int32_t *w, int32_t *a) {
+
+    if (ramp_time == 0) {
+        // Constant acceleration. Includes conversion from microseconds to
+        // seconds, in two steps to avoid overflows and round off errors.
+        *w = w_start + mul_a_by_t(a_peak, time);
+        *th = mul_w_by_t(w_start, time) + mul_a_by_t2(a_peak, time);
+        *a = a_peak;
+    } else if (time < ramp_time) {
+        // Acceleration ramps up.
+        *w = w_start + pbio_int_math_mult_then_div(mul_a_by_t(a_peak, time), time, ramp_time * 2);
+        *th = mul_w_by_t(w_start, time) + pbio_int_math_mult_then_div(mul_a_by_t2(a_peak, time), time, ramp_time * 3);
+        *a = a_peak * time / ramp_time;
+    } else if (time < duration - ramp_time) {
+        // Constant acceleration, starting from where the ramp up ends.
+        int32_t w_ramp = w_start + mul_a_by_t(a_peak, ramp_time) / 2;
+        int32_t th_ramp = mul_w_by_t(w_start, ramp_time) + mul_a_by_t2(a_peak, ramp_time) / 3;
+        *w = w_ramp + mul_a_by_t(a_peak, time - ramp_time);
+        *th = th_ramp + mul_w_by_t(w_ramp, time - ramp_time) + mul_a_by_t2(a_peak, time - ramp_time);
+        *a = a_peak;
+    } else {
+        // Acceleration ramps down. This mirrors the ramp up, relative to the
+        // end of the phase, so the phase ends exactly at the final speed.
+        int32_t time_left = duration - time;
+        *w = w_end - pbio_int_math_mult_then_div(mul_a_by_t(a_peak, time_left), time_left, ramp_time * 2);
+        *th = get_phase_angle(w_start, w_end, duration) - mul_w_by_t(w_end, time_left) +
+            pbio_int_math_mult_then_div(mul_a_by_t2(a_peak, time_left), time_left, ramp_time * 3);
+        *a = a_peak * time_left / ramp_time;
+    }
+}
+
 /**
  * Gets the calculated reference speed and velocity of the trajectory at the (shifted) time.
  *
@@ -933,11 +1307,7 @@ void pbio_trajectory_get_reference(pbio_trajectory_t *trj, uint32_t time_ref, pb
 
     if (time - trj->t1 < 0 || (trj->t1 == 0 && time == 0)) {
         // If we are here, then we are still in the acceleration phase.
-        // Includes conversion from microseconds to seconds, in two steps to
-        // avoid overflows and round off errors
-        w = trj->w0 + mul_a_by_t(trj->a0, time);
-        th = mul_w_by_t(trj->w0, time) + mul_a_by_t2(trj->a0, time);
-        a = trj->a0;
+        get_phase_reference(time, trj->t1, trj->tj0, trj->w0, trj->w1, trj->a0, &th, &w, &a);
     } else if (time - trj->t2 < 0) {
         // If we are here, then we are in the constant speed phase
         w = trj->w1;
@@ -945,9 +1315,8 @@ void pbio_trajectory_get_reference(pbio_trajectory_t *trj, uint32_t time_ref, pb
         a = 0;
     } else if (time - trj->t3 < 0) {
         // If we are here, then we are in the deceleration phase
-        w = trj->w1 + mul_a_by_t(trj->a2, time - trj->t2);
-        th = trj->th2 + mul_w_by_t(trj->w1, time - trj->t2) + mul_a_by_t2(trj->a2, time - trj->t2);
-        a = trj->a2;
+        get_phase_reference(time - trj->t2, trj->t3 - trj->t2, trj->tj2, trj->w1, trj->w3, trj->a2, &th, &w, &a);
+        th += trj->th2;
     } else {
         // If we are here, we are in the constant speed phase after the
         // maneuver completes
@@ -51,3 +51,33 @@ bool pbio_oneshot(bool value, bool *state) {
 
     return ret;
 }
+
+// CRC-32 of each 4-bit value, for computing the checksum one nibble at a
+// time. This is several times faster than computing it bitwise, but needs
+// only 64 bytes instead of 1 KiB for a full table.
+static const uint32_t crc32_nibble_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/**
+ * Computes the CRC-32 checksum of @p data.
+ *
+ * This is the same checksum as used by zlib, so hosts can compute it with
+ * standard libraries.
+ *
+ * @param [in]  data    The data.
+ * @param [in]  size    The size of @p data in bytes.
+ * @return              The checksum.
+ */
+uint32_t pbio_crc32(const uint8_t *data, uint32_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0xF];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0xF];
+    }
+
+    return ~crc;
+}
@@ -22,6 +22,8 @@
 #include <pbsys/command.h>
 #include <pbsys/status.h>
 
+#include "./program_load.h"
+
 // REVISIT: this can be the negotiated MTU - 3 to allow for better throughput
 #define MAX_CHAR_SIZE 20
 
@@ -38,6 +40,7 @@ typedef struct {
 } send_msg_t;
 
 static send_msg_t stdout_msg;
+static send_msg_t checksums_msg;
 LIST(send_queue);
 static bool send_busy;
 
@@ -180,6 +183,60 @@ pbio_error_t pbsys_bluetooth_tx(const uint8_t *data, uint32_t *size) {
     return PBIO_SUCCESS;
 }
 
+/**
+ * Queues a reply with the checksums of consecutive blocks of user RAM.
+ *
+ * @param [in]  offset  The offset of the first block from the base user RAM address.
+ * @param [in]  size    The size of each block in bytes.
+ * @param [in]  count   The number of blocks.
+ * @return              ::PBIO_ERROR_INVALID_ARG if @p count is out of range,
+ *                      if the blocks are too large in total, or if they are
+ *                      outside of user RAM.
+ *                      ::PBIO_ERROR_BUSY if a user program is running or if
+ *                      a previous reply was not sent yet.
+ *                      Otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbsys_bluetooth_send_user_ram_checksums(uint32_t offset, uint32_t size, uint8_t count) {
+    if (count == 0 || count > PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // This runs in the command handler, so limit the amount of data so that
+    // other processes such as motor control are not held up for too long.
+    if (size > PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE / count) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // While a program runs, user RAM holds its heap instead of the program.
+    if (pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING)) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    if (checksums_msg.is_queued) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    checksums_msg.payload[0] = PBIO_PYBRICKS_EVENT_USER_RAM_CHECKSUMS;
+    pbio_set_uint32_le(&checksums_msg.payload[1], offset);
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t checksum;
+        pbio_error_t err = pbsys_program_load_get_program_data_checksum(offset + i * size, size, &checksum);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+        pbio_set_uint32_le(&checksums_msg.payload[5 + i * sizeof(checksum)], checksum);
+    }
+
+    checksums_msg.context.size = 5 + count * sizeof(uint32_t);
+    checksums_msg.context.connection = PBDRV_BLUETOOTH_CONNECTION_PYBRICKS;
+    list_add(send_queue, &checksums_msg);
+    checksums_msg.is_queued = true;
+    process_poll(&pbsys_bluetooth_process);
+
+    return PBIO_SUCCESS;
+}
+
 /**
  * Tests if the Tx queue is empty and all data has been sent over the air.
  *
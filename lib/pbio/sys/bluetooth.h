@@ -6,7 +6,10 @@
 
 #include <stdint.h>
 
+#include <pbio/error.h>
+
 uint32_t pbsys_bluetooth_rx_get_free(void);
 void pbsys_bluetooth_rx_write(const uint8_t *data, uint32_t size);
+pbio_error_t pbsys_bluetooth_send_user_ram_checksums(uint32_t offset, uint32_t size, uint8_t count);
 
 #endif // _PBSYS_SYS_BLUETOOTH_H_
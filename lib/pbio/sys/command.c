@@ -48,6 +48,16 @@ pbio_pybricks_error_t pbsys_command(const uint8_t *data, uint32_t size) {
             #endif
             // If no consumers are configured, goes to "/dev/null" without error
             return PBIO_PYBRICKS_ERROR_OK;
+        case PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS:
+            #if PBSYS_CONFIG_BLUETOOTH
+            if (size < 10) {
+                return PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED;
+            }
+            return pbio_pybricks_error_from_pbio_error(pbsys_bluetooth_send_user_ram_checksums(
+                pbio_get_uint32_le(&data[1]), pbio_get_uint32_le(&data[5]), data[9]));
+            #else
+            return PBIO_PYBRICKS_ERROR_INVALID_COMMAND;
+            #endif
         default:
             return PBIO_PYBRICKS_ERROR_INVALID_COMMAND;
     }
@@ -14,6 +14,7 @@
 #include <pbdrv/block_device.h>
 #include <pbio/main.h>
 #include <pbio/protocol.h>
+#include <pbio/util.h>
 #include <pbsys/main.h>
 #include <pbsys/program_load.h>
 #include <pbsys/status.h>
@@ -169,6 +170,27 @@ pbio_error_t pbsys_program_load_set_program_data(uint32_t offset, const void *da
     return PBIO_SUCCESS;
 }
 
+/**
+ * Computes the checksum of data in user RAM.
+ *
+ * @param [in]  offset      The offset in bytes from the base user RAM address.
+ * @param [in]  size        The number of bytes.
+ * @param [out] checksum    The CRC-32 checksum of the data.
+ *
+ * @returns                 ::PBIO_ERROR_INVALID_ARG if requested @p offset and
+ *                          @p size are outside of the allocated user RAM.
+ *                          Otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbsys_program_load_get_program_data_checksum(uint32_t offset, uint32_t size, uint32_t *checksum) {
+    if (offset > sizeof(map->program_data) || size > sizeof(map->program_data) - offset) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    *checksum = pbio_crc32(map->program_data + offset, size);
+
+    return PBIO_SUCCESS;
+}
+
 /**
  * Requests to start the user program.
  *
@@ -17,6 +17,7 @@ void pbsys_program_load_deinit(void);
 pbio_error_t pbsys_program_load_wait_command(pbsys_main_program_t *program);
 pbio_error_t pbsys_program_load_set_program_size(uint32_t size);
 pbio_error_t pbsys_program_load_set_program_data(uint32_t offset, const void *data, uint32_t size);
+pbio_error_t pbsys_program_load_get_program_data_checksum(uint32_t offset, uint32_t size, uint32_t *checksum);
 pbio_error_t pbsys_program_load_start_user_program(void);
 pbio_error_t pbsys_program_load_start_repl(void);
 
@@ -34,6 +35,9 @@ static inline pbio_error_t pbsys_program_load_set_program_size(uint32_t size) {
 static inline pbio_error_t pbsys_program_load_set_program_data(uint32_t offset, const void *data, uint32_t size) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
+static inline pbio_error_t pbsys_program_load_get_program_data_checksum(uint32_t offset, uint32_t size, uint32_t *checksum) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
 static inline pbio_error_t pbsys_program_load_start_user_program(void) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+// Host-side benchmarks of the pbio control primitives that run on every
+// control loop iteration. This is not a substitute for measuring on a hub,
+// but it catches regressions in the hot path before they ship.
+//
+// Run `make bench` in lib/pbio/test. This builds the test program with
+// optimizations and runs it with the --bench argument. Pass a benchmark name
+// to run only matching benchmarks and optionally a number of iterations, e.g.:
+//
+//     ./build-bench/test-pbio --bench trajectory 10000000
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_CYCLES (1)
+#else
+#define BENCH_HAVE_CYCLES (0)
+#endif
+
+#include <contiki.h>
+
+#include <pbdrv/legodev.h>
+#include <pbio/angle.h>
+#include <pbio/battery.h>
+#include <pbio/control.h>
+#include <pbio/int_math.h>
+#include <pbio/main.h>
+#include <pbio/observer.h>
+#include <pbio/servo.h>
+#include <pbio/trajectory.h>
+
+#include <test-pbio.h>
+
+#include "../../drv/core.h"
+#include "../../drv/clock/clock_test.h"
+#include "../../drv/motor_driver/motor_driver_virtual_simulation.h"
+
+#define MDEG_PER_DEG (1000)
+
+// Results are accumulated here so the compiler cannot drop the calls.
+static volatile int32_t sink;
+
+static pbio_trajectory_t trajectory;
+static uint32_t trajectory_duration;
+
+static pbio_servo_t *servo;
+static uint32_t num_servos;
+
+static void bench_trajectory_setup(void) {
+    pbio_trajectory_command_t command = {
+        .time_start = 0,
+        .position_start = { .rotations = 0, .millidegrees = 0 },
+        .position_end = { .rotations = 27, .millidegrees = 280 * MDEG_PER_DEG },
+        .speed_start = 0,
+        .speed_target = 1000 * MDEG_PER_DEG,
+        .speed_max = 1000 * MDEG_PER_DEG,
+        .acceleration = 2000 * MDEG_PER_DEG,
+        .deceleration = 2000 * MDEG_PER_DEG,
+        .continue_running = false,
+    };
+    if (pbio_trajectory_new_angle_command(&trajectory, &command) != PBIO_SUCCESS) {
+        fprintf(stderr, "failed to make trajectory\n");
+        exit(1);
+    }
+    trajectory_duration = pbio_trajectory_get_duration(&trajectory);
+}
+
+static void bench_trajectory_run(uint32_t i) {
+    // Sweep through all phases of the trajectory, including the end.
+    pbio_trajectory_reference_t ref;
+    pbio_trajectory_get_reference(&trajectory, i % (trajectory_duration + 10000), &ref);
+    sink += ref.speed;
+}
+
+static void bench_trajectory_new_run(uint32_t i) {
+    pbio_trajectory_command_t command = {
+        .time_start = i,
+        .position_start = { .rotations = 0, .millidegrees = 0 },
+        .position_end = { .rotations = 0, .millidegrees = (int32_t)(i % 3600 + 1) * MDEG_PER_DEG },
+        .speed_start = 0,
+        .speed_target = 500 * MDEG_PER_DEG,
+        .speed_max = 1000 * MDEG_PER_DEG,
+        .acceleration = 2000 * MDEG_PER_DEG,
+        .deceleration = 2000 * MDEG_PER_DEG,
+        .continue_running = false,
+    };
+    pbio_trajectory_t trj;
+    sink += pbio_trajectory_new_angle_command(&trj, &command);
+}
+
+static void bench_servo_setup(void) {
+    pbio_init();
+    pbdrv_motor_driver_init_manual();
+    while (pbdrv_init_busy()) {
+        pbio_do_one_event();
+    }
+
+    // Normally done by the motor process, which the benchmarks replace.
+    pbio_battery_init();
+
+    // Set up every port with a motor and start a long maneuver on each.
+    for (uint8_t i = 0; i < PBIO_CONFIG_SERVO_NUM_DEV; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        pbio_servo_t *srv;
+        if (pbdrv_legodev_get_device(PBIO_PORT_ID_A + i, &id, &legodev) != PBIO_SUCCESS ||
+            pbio_servo_get_servo(legodev, &srv) != PBIO_SUCCESS ||
+            pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0) != PBIO_SUCCESS ||
+            pbio_servo_run_angle(srv, 500, 100000, PBIO_CONTROL_ON_COMPLETION_HOLD) != PBIO_SUCCESS) {
+            continue;
+        }
+        if (!servo) {
+            servo = srv;
+        }
+        num_servos++;
+    }
+    if (!servo) {
+        fprintf(stderr, "failed to set up servos\n");
+        exit(1);
+    }
+}
+
+static void bench_control_run(uint32_t i) {
+    pbio_control_state_t state;
+    pbio_servo_get_state_control(servo, &state);
+
+    pbio_trajectory_reference_t ref;
+    pbio_dcmotor_actuation_t actuation;
+    int32_t control;
+    bool external_pause = false;
+    pbio_control_update(&servo->control, servo->control.trajectory.start.time + i % 100000, &state, &ref, &actuation, &control, &external_pause);
+    sink += control;
+}
+
+static void bench_observer_run(uint32_t i) {
+    pbio_angle_t angle = { .rotations = 0, .millidegrees = (int32_t)(i % 360000) };
+    pbio_observer_update(&servo->observer, i, &angle, PBIO_DCMOTOR_ACTUATION_VOLTAGE, (int32_t)(i % 9000));
+    sink += servo->observer.speed_numeric;
+}
+
+static void bench_servo_update_all_run(uint32_t i) {
+    // Advance time as the motor process would.
+    pbio_test_clock_tick(PBIO_CONFIG_CONTROL_LOOP_TIME_MS);
+    pbio_servo_update_all();
+}
+
+static void bench_atan2_run(uint32_t i) {
+    sink += pbio_int_math_atan2((int32_t)(i % 20001) - 10000, (int32_t)((i * 7) % 20001) - 10000);
+}
+
+static void bench_sqrt_run(uint32_t i) {
+    sink += pbio_int_math_sqrt(i & 0x3fffffff);
+}
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*run)(uint32_t i);
+    uint32_t iterations;
+} bench_t;
+
+static const bench_t benchmarks[] = {
+    { "trajectory_get_reference", bench_trajectory_setup, bench_trajectory_run, 10000000 },
+    { "trajectory_new_angle_command", NULL, bench_trajectory_new_run, 1000000 },
+    { "control_update", bench_servo_setup, bench_control_run, 2000000 },
+    { "observer_update", bench_servo_setup, bench_observer_run, 2000000 },
+    { "servo_update_all", bench_servo_setup, bench_servo_update_all_run, 200000 },
+    { "int_math_atan2", NULL, bench_atan2_run, 10000000 },
+    { "int_math_sqrt", NULL, bench_sqrt_run, 10000000 },
+};
+
+static uint64_t bench_get_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static uint64_t bench_get_cycles(void) {
+    #if BENCH_HAVE_CYCLES
+    return __rdtsc();
+    #else
+    return 0;
+    #endif
+}
+
+int pbio_test_bench_main(int argc, const char **argv) {
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    uint32_t iterations = argc > 2 ? strtoul(argv[2], NULL, 0) : 0;
+
+    printf("%-30s %12s %12s %12s\n", "benchmark", "iterations", "ns/call", "cycles/call");
+
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        const bench_t *bench = &benchmarks[b];
+        if (filter && !strstr(bench->name, filter)) {
+            continue;
+        }
+
+        if (bench->setup && (bench->setup != bench_servo_setup || !servo)) {
+            bench->setup();
+        }
+
+        uint32_t n = iterations ? iterations : bench->iterations;
+
+        uint64_t ns_start = bench_get_ns();
+        uint64_t cycles_start = bench_get_cycles();
+        for (uint32_t i = 0; i < n; i++) {
+            bench->run(i);
+        }
+        uint64_t cycles = bench_get_cycles() - cycles_start;
+        uint64_t ns = bench_get_ns() - ns_start;
+
+        if (BENCH_HAVE_CYCLES) {
+            printf("%-30s %12u %12.1f %12.1f\n", bench->name, n, (double)ns / n, (double)cycles / n);
+        } else {
+            printf("%-30s %12u %12.1f %12s\n", bench->name, n, (double)ns / n, "-");
+        }
+    }
+
+    printf("%u servos, ", num_servos);
+
+    uint32_t hits, misses;
+    pbio_trajectory_get_cache_stats(&hits, &misses);
+    printf("trajectory cache: %u hits, %u misses\n", hits, misses);
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+// Host-side replay of recorded servo logs through the pbio servo update. This
+// makes it possible to evaluate controller changes on logs recorded on hubs,
+// without the hub.
+//
+// The input is a log saved with Logger.save() from Motor.log. For each row,
+// the measured angle is passed to the same servo update that the motor
+// process runs on the hub, as if it was running a run_target() command from
+// the first logged angle. Everything else, like the controller, actuation
+// and observer, is computed by the update as usual. The servo logger output
+// of the replay is printed in the same format as the input log.
+//
+// Save this output as a golden file and pass it in on later runs to compare
+// against it. Differences are reported and give a nonzero exit code:
+//
+//     ./build/test-pbio --replay A motor.txt 360 500 > golden.txt
+//     ./build/test-pbio --replay A motor.txt 360 500 golden.txt > /dev/null
+//
+// The port selects the motor type, as configured by the test platform in
+// lib/pbio/platform/test. The target angle (deg) and speed (deg/s) describe
+// the run_target() command that was running during the log.
+//
+// The log must have all columns. Logs started with a column selection can't
+// be replayed, since the saved rows don't say which columns they contain.
+//
+// Run `make replay` to replay the log in replay/run_target.txt and compare it
+// against replay/run_target.golden.txt.
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <contiki.h>
+
+#include <pbdrv/clock.h>
+#include <pbdrv/legodev.h>
+#include <pbio/angle.h>
+#include <pbio/battery.h>
+#include <pbio/control.h>
+#include <pbio/logger.h>
+#include <pbio/main.h>
+#include <pbio/servo.h>
+#include <pbio/trajectory.h>
+
+#include <test-pbio.h>
+
+#include "../../drv/core.h"
+#include "../../drv/clock/clock_test.h"
+#include "../../drv/motor_driver/motor_driver_virtual_simulation.h"
+
+// Columns of a saved servo log, including the logger time in column 0.
+#define LOG_COL_TIME (1)
+#define LOG_COL_ANGLE (2)
+#define LOG_NUM_COLS (PBIO_SERVO_LOGGER_NUM_COLS + PBIO_LOGGER_NUM_DEFAULT_COLS)
+
+/**
+ * Reads one row of comma separated integers.
+ *
+ * @param [in]  file        The file to read from.
+ * @param [out] values      The values of the row.
+ * @param [in]  max_values  Maximum number of values to read.
+ * @return                  Number of values read, or -1 at end of file.
+ */
+static int replay_read_row(FILE *file, int32_t *values, int max_values) {
+    char line[512];
+    if (!fgets(line, sizeof(line), file)) {
+        return -1;
+    }
+
+    int num_values = 0;
+    char *pos = line;
+    while (num_values < max_values) {
+        char *end;
+        long value = strtol(pos, &end, 10);
+        if (end == pos) {
+            break;
+        }
+        values[num_values++] = value;
+        pos = end;
+        while (*pos == ',' || *pos == ' ') {
+            pos++;
+        }
+    }
+    return num_values;
+}
+
+/**
+ * Parses a command line argument as a 32-bit integer.
+ *
+ * @param [in]  arg         The argument.
+ * @param [out] value       The parsed value.
+ * @return                  True if the whole argument is a valid integer.
+ */
+static bool replay_parse_int(const char *arg, int32_t *value) {
+    char *end;
+    errno = 0;
+    long result = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno == ERANGE || result < INT32_MIN || result > INT32_MAX) {
+        return false;
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * Sets up the servo on the given port without starting the motor process,
+ * so that the replay can run the servo update with logged angles.
+ *
+ * @param [in]  port        The port.
+ * @return                  The servo or NULL if it could not be set up.
+ */
+static pbio_servo_t *replay_servo_setup(pbio_port_id_t port) {
+    pbio_init();
+    pbdrv_motor_driver_init_manual();
+    while (pbdrv_init_busy()) {
+        pbio_do_one_event();
+    }
+
+    // Normally done by the motor process.
+    pbio_battery_init();
+
+    pbdrv_legodev_dev_t *legodev;
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    pbio_servo_t *srv;
+    if (pbdrv_legodev_get_device(port, &id, &legodev) != PBIO_SUCCESS ||
+        pbio_servo_get_servo(legodev, &srv) != PBIO_SUCCESS ||
+        pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0) != PBIO_SUCCESS) {
+        return NULL;
+    }
+    return srv;
+}
+
+int pbio_test_replay_main(int argc, const char **argv) {
+    int32_t target;
+    int32_t speed;
+    if (argc < 5 || argc > 6 || strlen(argv[1]) != 1 || argv[1][0] < 'A' || argv[1][0] > 'F' ||
+        !replay_parse_int(argv[3], &target) || !replay_parse_int(argv[4], &speed)) {
+        fprintf(stderr, "usage: --replay <port A-F> <log> <target (deg)> <speed (deg/s)> [golden]\n");
+        return 2;
+    }
+
+    FILE *log_file = fopen(argv[2], "r");
+    if (!log_file) {
+        perror(argv[2]);
+        return 2;
+    }
+
+    FILE *golden_file = NULL;
+    if (argc > 5) {
+        golden_file = fopen(argv[5], "r");
+        if (!golden_file) {
+            perror(argv[5]);
+            return 2;
+        }
+    }
+
+    pbio_servo_t *srv = replay_servo_setup(PBIO_PORT_ID_A + argv[1][0] - 'A');
+    if (!srv) {
+        fprintf(stderr, "failed to set up servo on port %s\n", argv[1]);
+        return 2;
+    }
+
+    // The replayed rows are read back from the servo logger one by one.
+    int32_t replay_row_buf[LOG_NUM_COLS];
+    pbio_logger_start_stream(&srv->log, replay_row_buf, 1, PBIO_LOGGER_COLUMNS_ALL(PBIO_SERVO_LOGGER_NUM_COLS), 1);
+
+    uint32_t num_rows = 0;
+    uint32_t num_mismatches = 0;
+    uint32_t log_time_start = 0;
+
+    // The command is started one control loop before the first row, as when
+    // the log and the command are started together.
+    uint32_t time_start = pbio_control_get_time_ticks() + pbio_control_time_ms_to_ticks(PBIO_CONFIG_CONTROL_LOOP_TIME_MS);
+
+    // One more than needed, to detect rows that are too long.
+    int32_t log_row[LOG_NUM_COLS + 1];
+    int num_cols;
+    while ((num_cols = replay_read_row(log_file, log_row, LOG_NUM_COLS + 1)) >= 0) {
+        // Skip lines that are not log rows, such as headers.
+        if (num_cols == 0) {
+            continue;
+        }
+
+        // Anything else would replay the wrong columns.
+        if (num_cols != LOG_NUM_COLS) {
+            fprintf(stderr, "log row %u has %d columns instead of %d, was it logged with selected columns?\n",
+                num_rows, num_cols, LOG_NUM_COLS);
+            return 2;
+        }
+
+        // Start the command from the first logged angle.
+        if (num_rows == 0) {
+            log_time_start = log_row[LOG_COL_TIME];
+            if (pbio_servo_reset_angle(srv, log_row[LOG_COL_ANGLE], false) != PBIO_SUCCESS ||
+                pbio_servo_run_target(srv, speed, target, PBIO_CONTROL_ON_COMPLETION_HOLD) != PBIO_SUCCESS) {
+                fprintf(stderr, "failed to start run_target(%d, %d)\n", speed, target);
+                return 2;
+            }
+        }
+
+        // Keep the test clock in step with the log, for anything that reads it.
+        uint32_t time = time_start + log_row[LOG_COL_TIME] - log_time_start;
+        pbio_test_clock_tick(time / PBIO_TRAJECTORY_TICKS_PER_MS - pbdrv_clock_get_ms());
+
+        // Run the servo update with the measured angle.
+        pbio_angle_t angle;
+        pbio_control_settings_app_to_ctl_long(&srv->control.settings, log_row[LOG_COL_ANGLE], &angle);
+        pbio_error_t err = pbio_servo_update_with_angle(srv, time, &angle);
+        if (err != PBIO_SUCCESS || pbio_logger_get_num_rows_used(&srv->log) != 1) {
+            fprintf(stderr, "servo update failed on row %u\n", num_rows);
+            return 2;
+        }
+
+        int32_t *result = pbio_logger_get_row_data(&srv->log, 0);
+        for (int i = 0; i < LOG_NUM_COLS; i++) {
+            printf(i + 1 < LOG_NUM_COLS ? "%d, " : "%d\n", result[i]);
+        }
+
+        // Compare against the golden file, if given.
+        if (golden_file) {
+            int32_t golden[LOG_NUM_COLS];
+            if (replay_read_row(golden_file, golden, LOG_NUM_COLS) != LOG_NUM_COLS ||
+                memcmp(golden, result, sizeof(golden))) {
+                if (num_mismatches == 0) {
+                    fprintf(stderr, "first mismatch on row %u\n", num_rows);
+                }
+                num_mismatches++;
+            }
+        }
+        pbio_logger_consume_rows(&srv->log, 1);
+        num_rows++;
+    }
+
+    fclose(log_file);
+
+    if (num_rows == 0) {
+        fprintf(stderr, "no rows in %s\n", argv[2]);
+        return 2;
+    }
+
+    if (golden_file) {
+        // Rows left in the golden file were not replayed, so they differ too.
+        int32_t golden[LOG_NUM_COLS];
+        uint32_t num_extra = 0;
+        while ((num_cols = replay_read_row(golden_file, golden, LOG_NUM_COLS)) >= 0) {
+            if (num_cols > 0) {
+                num_extra++;
+            }
+        }
+        if (num_extra) {
+            if (num_mismatches == 0) {
+                fprintf(stderr, "first mismatch on row %u\n", num_rows);
+            }
+            fprintf(stderr, "%u extra rows in golden file\n", num_extra);
+            num_mismatches += num_extra;
+        }
+
+        fclose(golden_file);
+        fprintf(stderr, "%u rows, %u mismatches\n", num_rows, num_mismatches);
+    }
+
+    return num_mismatches ? 1 : 0;
+}
@@ -57,6 +57,8 @@ static PT_THREAD(test_drivebase_basics(struct pt *pt)) {
     static pbio_dcmotor_actuation_t actuation;
     static int32_t voltage;
 
+    static uint8_t count_max;
+
     // Start motor driver simulation process.
     pbdrv_motor_driver_init_manual();
 
@@ -160,6 +162,21 @@ static PT_THREAD(test_drivebase_basics(struct pt *pt)) {
     pbio_test_sleep_until(pbio_drivebase_is_done(db));
     tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
     tt_want(pbio_test_int_is_close(turn_angle, turn_angle_start + 360, 5));
+
+    // While holding, the controllers are updated as often as the servos
+    // would be, and it still holds.
+    tt_uint_op(pbio_servo_set_update_divisor(srv_left, 4), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_set_update_divisor(srv_right, 4), ==, PBIO_SUCCESS);
+    count_max = 0;
+    timer_set(&timer, 500);
+    while (!timer_expired(&timer)) {
+        count_max = pbio_int_math_max(count_max, db->update_count);
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    }
+    tt_want_uint_op(count_max, ==, 3);
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(turn_angle, turn_angle_start + 360, 5));
     tt_uint_op(pbio_drivebase_stop(db, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
 
     // Stopping a single servo should stop both servos and the drivebase.
@@ -183,7 +200,77 @@ end:
     PT_END(pt);
 }
 
+static PT_THREAD(test_drivebase_simulated_body(struct pt *pt)) {
+
+    static struct timer timer;
+
+    static pbio_servo_t *srv_left;
+    static pbio_servo_t *srv_right;
+    static pbdrv_legodev_dev_t *legodev_left;
+    static pbdrv_legodev_dev_t *legodev_right;
+    static pbio_drivebase_t *db;
+
+    static int32_t x;
+    static int32_t y;
+    static int32_t heading;
+
+    // Start motor driver simulation process, with the wheels on the ground.
+    pbdrv_motor_driver_init_manual_drivebase();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    // Initialize the servos as mounted on the simulated body.
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_A, &id, &legodev_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_left, &srv_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_left, id, PBIO_DIRECTION_COUNTERCLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev_right, &srv_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_right, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_get_drivebase(&db, srv_left, srv_right, 56000, 112000), ==, PBIO_SUCCESS);
+
+    // The robot should end up where the wheels took it.
+    tt_uint_op(pbio_drivebase_drive_straight(db, 500, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    pbio_test_sleep_ms(&timer, 200);
+    pbdrv_motor_driver_virtual_simulation_get_drivebase_state(&x, &y, &heading);
+    tt_want(pbio_test_int_is_close(x, 500, 10));
+    tt_want(pbio_test_int_is_close(y, 0, 5));
+    tt_want(pbio_test_int_is_close(heading, 0, 2));
+
+    // Turning in place should only change the heading.
+    tt_uint_op(pbio_drivebase_drive_curve(db, 0, 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    pbio_test_sleep_ms(&timer, 200);
+    pbdrv_motor_driver_virtual_simulation_get_drivebase_state(&x, &y, &heading);
+    tt_want(pbio_test_int_is_close(x, 500, 10));
+    tt_want(pbio_test_int_is_close(y, 0, 5));
+    tt_want(pbio_test_int_is_close(heading, 90, 3));
+
+    // Driving on from there goes to the right.
+    tt_uint_op(pbio_drivebase_drive_straight(db, 200, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_drivebase_is_done(db));
+    pbio_test_sleep_ms(&timer, 200);
+    pbdrv_motor_driver_virtual_simulation_get_drivebase_state(&x, &y, &heading);
+    tt_want(pbio_test_int_is_close(x, 500, 15));
+    tt_want(pbio_test_int_is_close(y, 200, 10));
+
+end:
+
+    PT_END(pt);
+}
+
 struct testcase_t pbio_drivebase_tests[] = {
     PBIO_PT_THREAD_TEST(test_drivebase_basics),
+    PBIO_PT_THREAD_TEST(test_drivebase_simulated_body),
     END_OF_TESTCASES
 };
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include <stdint.h>
+
+#include <pbio/logger.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#define TEST_NUM_ROWS (4)
+#define TEST_NUM_COLS (PBIO_LOGGER_NUM_DEFAULT_COLS + 1)
+#define TEST_COLUMNS PBIO_LOGGER_COLUMNS_ALL(1)
+
+static void test_logger_linear(void *env) {
+    pbio_log_t log;
+    int32_t buf[TEST_NUM_ROWS * TEST_NUM_COLS];
+
+    pbio_logger_start(&log, buf, TEST_NUM_ROWS, TEST_COLUMNS, 1);
+    tt_want(pbio_logger_is_active(&log));
+
+    // Fill the log and then some.
+    for (int32_t i = 0; i < TEST_NUM_ROWS + 2; i++) {
+        pbio_logger_add_row(&log, &i);
+    }
+
+    // Log stops when full and keeps the first rows.
+    tt_want(!pbio_logger_is_active(&log));
+    tt_want_uint_op(pbio_logger_get_num_rows_used(&log), ==, TEST_NUM_ROWS);
+    for (uint32_t i = 0; i < TEST_NUM_ROWS; i++) {
+        tt_want_int_op(pbio_logger_get_row_data(&log, i)[1], ==, i);
+    }
+
+    // Consuming rows has no effect outside of streaming mode.
+    pbio_logger_consume_rows(&log, 2);
+    tt_want_uint_op(pbio_logger_get_num_rows_used(&log), ==, TEST_NUM_ROWS);
+}
+
+static void test_logger_stream(void *env) {
+    pbio_log_t log;
+    int32_t buf[TEST_NUM_ROWS * TEST_NUM_COLS];
+
+    pbio_logger_start_stream(&log, buf, TEST_NUM_ROWS, TEST_COLUMNS, 1);
+
+    // Produce and consume many more rows than fit in the buffer.
+    int32_t produced = 0;
+    int32_t consumed = 0;
+    for (uint32_t cycle = 0; cycle < 10; cycle++) {
+        for (uint32_t i = 0; i < 3; i++) {
+            pbio_logger_add_row(&log, &produced);
+            produced++;
+        }
+        uint32_t num_rows = pbio_logger_get_num_rows_used(&log);
+        tt_want_uint_op(num_rows, ==, 3);
+        for (uint32_t i = 0; i < num_rows; i++) {
+            tt_want_int_op(pbio_logger_get_row_data(&log, i)[1], ==, consumed);
+            consumed++;
+        }
+        pbio_logger_consume_rows(&log, num_rows);
+    }
+    tt_want(pbio_logger_is_active(&log));
+    tt_want_uint_op(pbio_logger_get_num_rows_used(&log), ==, 0);
+    tt_want_uint_op(pbio_logger_get_num_rows_dropped(&log), ==, 0);
+
+    // If the consumer does not keep up, new rows are dropped and old rows kept.
+    for (int32_t i = 0; i < TEST_NUM_ROWS + 3; i++) {
+        int32_t value = produced + i;
+        pbio_logger_add_row(&log, &value);
+    }
+    tt_want(pbio_logger_is_active(&log));
+    tt_want_uint_op(pbio_logger_get_num_rows_used(&log), ==, TEST_NUM_ROWS);
+    tt_want_uint_op(pbio_logger_get_num_rows_dropped(&log), ==, 3);
+    tt_want_int_op(pbio_logger_get_row_data(&log, 0)[1], ==, produced);
+
+    // Consuming more rows than available only consumes what is there.
+    pbio_logger_consume_rows(&log, TEST_NUM_ROWS + 1);
+    tt_want_uint_op(pbio_logger_get_num_rows_used(&log), ==, 0);
+}
+
+static void test_logger_columns(void *env) {
+    pbio_log_t log;
+    int32_t buf[TEST_NUM_ROWS * (PBIO_LOGGER_NUM_DEFAULT_COLS + 2)];
+
+    tt_want_uint_op(pbio_logger_get_num_cols(PBIO_LOGGER_COLUMNS_ALL(10)), ==, PBIO_LOGGER_NUM_DEFAULT_COLS + 10);
+    tt_want_uint_op(pbio_logger_get_num_cols(0), ==, PBIO_LOGGER_NUM_DEFAULT_COLS);
+
+    // Select only the second and fourth value.
+    pbio_logger_start(&log, buf, TEST_NUM_ROWS, (1 << 1) | (1 << 3), 1);
+    tt_want_uint_op(log.num_cols, ==, PBIO_LOGGER_NUM_DEFAULT_COLS + 2);
+    tt_want(!pbio_logger_column_is_enabled(&log, 0));
+    tt_want(pbio_logger_column_is_enabled(&log, 1));
+    tt_want(!pbio_logger_column_is_enabled(&log, 2));
+    tt_want(pbio_logger_column_is_enabled(&log, 3));
+
+    int32_t row_data[] = { 10, 11, 12, 13, 14 };
+    pbio_logger_add_row(&log, row_data);
+    int32_t *row = pbio_logger_get_row_data(&log, 0);
+    tt_want_int_op(row[PBIO_LOGGER_NUM_DEFAULT_COLS], ==, 11);
+    tt_want_int_op(row[PBIO_LOGGER_NUM_DEFAULT_COLS + 1], ==, 13);
+}
+
+static void test_logger_encode_varint(void *env) {
+    uint8_t buf[PBIO_LOGGER_VARINT_SIZE_MAX];
+
+    // Zig-zag encoding maps small magnitudes to one byte.
+    tt_want_uint_op(pbio_logger_encode_varint(buf, 0), ==, 1);
+    tt_want_uint_op(buf[0], ==, 0);
+    tt_want_uint_op(pbio_logger_encode_varint(buf, -1), ==, 1);
+    tt_want_uint_op(buf[0], ==, 1);
+    tt_want_uint_op(pbio_logger_encode_varint(buf, 1), ==, 1);
+    tt_want_uint_op(buf[0], ==, 2);
+    tt_want_uint_op(pbio_logger_encode_varint(buf, -64), ==, 1);
+    tt_want_uint_op(buf[0], ==, 127);
+
+    // Larger values use more bytes, least significant group first.
+    tt_want_uint_op(pbio_logger_encode_varint(buf, 64), ==, 2);
+    tt_want_uint_op(buf[0], ==, 0x80);
+    tt_want_uint_op(buf[1], ==, 0x01);
+    tt_want_uint_op(pbio_logger_encode_varint(buf, INT32_MIN), ==, PBIO_LOGGER_VARINT_SIZE_MAX);
+    tt_want_uint_op(buf[4], ==, 0x0f);
+}
+
+static void test_logger_encode_row(void *env) {
+    pbio_log_t log;
+    int32_t buf[TEST_NUM_ROWS * TEST_NUM_COLS];
+    uint8_t encoded[PBIO_LOGGER_BINARY_HEADER_SIZE + TEST_NUM_COLS * PBIO_LOGGER_VARINT_SIZE_MAX];
+
+    pbio_logger_start(&log, buf, TEST_NUM_ROWS, TEST_COLUMNS, 1);
+    int32_t value = 1000;
+    pbio_logger_add_row(&log, &value);
+    value = 1001;
+    pbio_logger_add_row(&log, &value);
+
+    // The header describes the number of rows and columns.
+    tt_want_uint_op(pbio_logger_encode_header(&log, encoded), ==, PBIO_LOGGER_BINARY_HEADER_SIZE + TEST_NUM_COLS);
+    tt_want_uint_op(encoded[5], ==, TEST_NUM_COLS);
+    tt_want_uint_op(encoded[6], ==, 2);
+
+    // The second row is stored as a small difference with the first row.
+    buf[0] = buf[TEST_NUM_COLS] = 0;
+    tt_want_uint_op(pbio_logger_encode_row(&log, 0, encoded), ==, 1 + 2);
+    tt_want_uint_op(pbio_logger_encode_row(&log, 1, encoded), ==, 1 + 1);
+    tt_want_uint_op(encoded[1], ==, 2);
+}
+
+struct testcase_t pbio_logger_tests[] = {
+    PBIO_TEST(test_logger_linear),
+    PBIO_TEST(test_logger_stream),
+    PBIO_TEST(test_logger_columns),
+    PBIO_TEST(test_logger_encode_varint),
+    PBIO_TEST(test_logger_encode_row),
+    END_OF_TESTCASES
+};
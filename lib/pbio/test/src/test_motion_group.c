@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include <stdint.h>
+
+#include <contiki.h>
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbio/control.h>
+#include <pbio/error.h>
+#include <pbio/int_math.h>
+#include <pbio/motion_group.h>
+#include <pbio/motor_process.h>
+#include <pbio/servo.h>
+#include <test-pbio.h>
+
+#include "../drv/core.h"
+#include "../drv/clock/clock_test.h"
+#include "../drv/motor_driver/motor_driver_virtual_simulation.h"
+
+#define NUM_SERVOS (3)
+
+static PT_THREAD(test_motion_group_run_target(struct pt *pt)) {
+
+    static const pbio_port_id_t ports[NUM_SERVOS] = { PBIO_PORT_ID_A, PBIO_PORT_ID_B, PBIO_PORT_ID_E };
+    static const int32_t targets[NUM_SERVOS] = { 90, 360, -180 };
+    static pbio_servo_t *servos[NUM_SERVOS];
+    static pbio_motion_group_t group;
+    static uint32_t time_done[NUM_SERVOS];
+    static uint32_t time_start;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        tt_uint_op(pbdrv_legodev_get_device(ports[i], &id, &legodev), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_get_servo(legodev, &servos[i]), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_setup(servos[i], id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_reset_angle(servos[i], 0, false), ==, PBIO_SUCCESS);
+    }
+
+    // Groups need at least one servo, and each servo only once.
+    tt_uint_op(pbio_motion_group_setup(&group, servos, 0), ==, PBIO_ERROR_INVALID_ARG);
+    static pbio_servo_t *duplicates[] = { NULL, NULL };
+    duplicates[0] = duplicates[1] = servos[0];
+    tt_uint_op(pbio_motion_group_setup(&group, duplicates, 2), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_motion_group_setup(&group, servos, NUM_SERVOS), ==, PBIO_SUCCESS);
+
+    // All trajectories should start and end at the same time, even though
+    // they travel different distances.
+    tt_uint_op(pbio_motion_group_run_target(&group, 500, targets, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    time_start = servos[0]->control.trajectory.start.time;
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        tt_want_uint_op(servos[i]->control.trajectory.start.time, ==, time_start);
+        tt_want_uint_op(pbio_trajectory_get_duration(&servos[i]->control.trajectory), ==,
+            pbio_trajectory_get_duration(&servos[1]->control.trajectory));
+    }
+    tt_want(!pbio_motion_group_is_done(&group));
+
+    // Record when each of them reaches the target.
+    for (;;) {
+        for (int i = 0; i < NUM_SERVOS; i++) {
+            if (!time_done[i] && pbio_control_is_done(&servos[i]->control)) {
+                time_done[i] = pbio_control_get_time_ticks();
+            }
+        }
+        if (pbio_motion_group_is_done(&group)) {
+            break;
+        }
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    }
+
+    // They should arrive together, close to their targets.
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        int32_t angle, speed;
+        tt_uint_op(pbio_servo_get_state_user(servos[i], &angle, &speed), ==, PBIO_SUCCESS);
+        tt_want(pbio_test_int_is_close(angle, targets[i], 5));
+        tt_want(pbio_test_int_is_close(time_done[i], time_done[1], 1000));
+    }
+
+    // Stopping the group stops all servos.
+    tt_uint_op(pbio_motion_group_stop(&group, PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        tt_want(!pbio_control_is_active(&servos[i]->control));
+    }
+
+end:
+
+    PT_END(pt);
+}
+
+static PT_THREAD(test_motion_group_run_targets(struct pt *pt)) {
+
+    static const pbio_port_id_t ports[NUM_SERVOS] = { PBIO_PORT_ID_A, PBIO_PORT_ID_B, PBIO_PORT_ID_E };
+    static const int32_t speeds[NUM_SERVOS] = { 200, 500, 300 };
+    static const int32_t targets[NUM_SERVOS] = { 90, 360, -180 };
+    static pbio_servo_t *servos[NUM_SERVOS];
+    static pbio_motion_group_t group;
+    static uint32_t time_start;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        pbdrv_legodev_dev_t *legodev;
+        pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+        tt_uint_op(pbdrv_legodev_get_device(ports[i], &id, &legodev), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_get_servo(legodev, &servos[i]), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_setup(servos[i], id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+        tt_uint_op(pbio_servo_reset_angle(servos[i], 0, false), ==, PBIO_SUCCESS);
+    }
+    tt_uint_op(pbio_motion_group_setup(&group, servos, NUM_SERVOS), ==, PBIO_SUCCESS);
+
+    // If the trajectory for one servo can't be made, none of them start.
+    static const int32_t targets_too_far[NUM_SERVOS] = { 90, 10000000, -180 };
+    tt_uint_op(pbio_motion_group_run_targets(&group, speeds, targets_too_far, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_ERROR_INVALID_ARG);
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        tt_want(!pbio_control_is_active(&servos[i]->control));
+    }
+
+    // All trajectories should start at the same time, but keep their own
+    // speed, so they don't finish together.
+    tt_uint_op(pbio_motion_group_run_targets(&group, speeds, targets, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    time_start = servos[0]->control.trajectory.start.time;
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        tt_want_uint_op(servos[i]->control.trajectory.start.time, ==, time_start);
+    }
+    tt_want_uint_op(pbio_trajectory_get_duration(&servos[0]->control.trajectory), <,
+        pbio_trajectory_get_duration(&servos[1]->control.trajectory));
+
+    pbio_test_sleep_until(pbio_motion_group_is_done(&group));
+
+    // Each of them should be close to its target.
+    for (int i = 0; i < NUM_SERVOS; i++) {
+        int32_t angle, speed;
+        tt_uint_op(pbio_servo_get_state_user(servos[i], &angle, &speed), ==, PBIO_SUCCESS);
+        tt_want(pbio_test_int_is_close(angle, targets[i], 5));
+    }
+
+end:
+
+    PT_END(pt);
+}
+
+struct testcase_t pbio_motion_group_tests[] = {
+    PBIO_PT_THREAD_TEST(test_motion_group_run_target),
+    PBIO_PT_THREAD_TEST(test_motion_group_run_targets),
+    END_OF_TESTCASES
+};
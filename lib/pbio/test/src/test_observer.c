@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include <stdint.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbdrv/legodev.h>
+#include <pbio/observer.h>
+#include <pbio/servo.h>
+#include <pbio/util.h>
+#include <test-pbio.h>
+
+// Number of values tested over the full range of each signal.
+#define NUM_STEPS (10000)
+
+// Tests that scaling by the reciprocal gives the same result as the division
+// for all values of the signal, except for rounding.
+#define TEST_RECIPROCAL(model, x, y, signal) \
+    for (int32_t i = -NUM_STEPS; i <= NUM_STEPS; i++) { \
+        int32_t value = (int64_t)PBIO_OBSERVER_MAX_NUM_##signal * i / NUM_STEPS; \
+        int32_t expected = PBIO_OBSERVER_PRESCALE_##signal * value / (model)->d_##x##_d_##y; \
+        int32_t result = pbio_observer_model_scale(value, (model)->d_##x##_d_##y##_reciprocal); \
+        tt_want(pbio_test_int_is_close(result, expected, 1)); \
+    }
+
+static void test_observer_model_reciprocals(void *env) {
+
+    static const pbdrv_legodev_type_id_t ids[] = {
+        PBDRV_LEGODEV_TYPE_ID_EV3_MEDIUM_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_EV3_LARGE_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_MOVE_HUB_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_INTERACTIVE_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_TECHNIC_XL_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_SPIKE_S_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_TECHNIC_L_ANGULAR_MOTOR,
+        PBDRV_LEGODEV_TYPE_ID_TECHNIC_M_ANGULAR_MOTOR,
+    };
+
+    for (uint8_t m = 0; m < PBIO_ARRAY_SIZE(ids); m++) {
+        const pbio_servo_settings_reduced_t *settings = pbio_servo_get_reduced_settings(ids[m]);
+        tt_assert(settings);
+        const pbio_observer_model_t *model = settings->model;
+
+        TEST_RECIPROCAL(model, angle, speed, SPEED);
+        TEST_RECIPROCAL(model, speed, speed, SPEED);
+        TEST_RECIPROCAL(model, current, speed, SPEED);
+        TEST_RECIPROCAL(model, angle, current, CURRENT);
+        TEST_RECIPROCAL(model, speed, current, CURRENT);
+        TEST_RECIPROCAL(model, current, current, CURRENT);
+        TEST_RECIPROCAL(model, angle, voltage, VOLTAGE);
+        TEST_RECIPROCAL(model, speed, voltage, VOLTAGE);
+        TEST_RECIPROCAL(model, current, voltage, VOLTAGE);
+        TEST_RECIPROCAL(model, angle, torque, TORQUE);
+        TEST_RECIPROCAL(model, speed, torque, TORQUE);
+        TEST_RECIPROCAL(model, current, torque, TORQUE);
+    }
+
+end:
+    ;
+}
+
+struct testcase_t pbio_observer_tests[] = {
+    PBIO_TEST(test_observer_model_reciprocals),
+    END_OF_TESTCASES
+};
@@ -19,6 +19,7 @@
 #include <pbio/angle.h>
 #include <pbio/control.h>
 #include <pbio/error.h>
+#include <pbio/event.h>
 #include <pbio/logger.h>
 #include <pbio/int_math.h>
 #include <pbio/motor_process.h>
@@ -219,9 +220,219 @@ end:
     PT_END(pt);
 }
 
+#if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
+static PT_THREAD(test_servo_queue(struct pt *pt)) {
+
+    static struct timer timer;
+    static pbio_servo_t *srv;
+    static pbdrv_legodev_dev_t *legodev;
+    static int32_t angle;
+    static int32_t speed;
+    static int32_t speed_min;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_reset_angle(srv, 0, false), ==, PBIO_SUCCESS);
+
+    // Without ongoing motion, queueing starts right away.
+    tt_uint_op(pbio_servo_queue_target(srv, 500, 180, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want(pbio_control_is_active(&srv->control));
+    tt_want_uint_op(pbio_control_queue_get_size(&srv->control), ==, 0);
+
+    // Queue waypoints in the same direction, and one back.
+    tt_uint_op(pbio_servo_queue_target(srv, 500, 360, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_queue_target(srv, 500, 540, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_queue_target(srv, 500, 270, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbio_control_queue_get_size(&srv->control), ==, 3);
+
+    // Get up to speed, then check it does not slow down through the waypoints.
+    pbio_test_sleep_ms(&timer, 300);
+    speed_min = INT32_MAX;
+    do {
+        tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+        speed_min = pbio_int_math_min(speed_min, speed);
+        tt_want(!pbio_control_is_done(&srv->control));
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    } while (angle < 450);
+    tt_want_int_op(speed_min, >, 400);
+
+    // It should turn around to reach the last target and hold there.
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 270, 5));
+    tt_want_uint_op(pbio_control_queue_get_size(&srv->control), ==, 0);
+    tt_want(pbio_control_is_active(&srv->control));
+
+    // A full queue is rejected, and a regular command clears it.
+    for (int i = 0; i < PBIO_CONFIG_CONTROL_QUEUE_SIZE + 1; i++) {
+        tt_uint_op(pbio_servo_queue_target(srv, 500, 360 + i * 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    }
+    tt_uint_op(pbio_servo_queue_target(srv, 500, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_ERROR_BUSY);
+    tt_uint_op(pbio_servo_run_target(srv, 500, 0, PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbio_control_queue_get_size(&srv->control), ==, 0);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 0, 5));
+
+end:
+
+    PT_END(pt);
+}
+
+#endif // PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
+static PT_THREAD(test_servo_update_divisor(struct pt *pt)) {
+
+    static struct timer timer;
+    static pbio_servo_t *srv;
+    static pbdrv_legodev_dev_t *legodev;
+    static int32_t angle;
+    static int32_t speed;
+    static uint8_t count_max;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_reset_angle(srv, 0, false), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbio_servo_get_update_divisor(srv), ==, PBIO_CONFIG_SERVO_UPDATE_DIVISOR_IDLE);
+
+    // Divisor must be in range.
+    tt_uint_op(pbio_servo_set_update_divisor(srv, 0), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_servo_set_update_divisor(srv, PBIO_SERVO_UPDATE_DIVISOR_MAX + 1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_uint_op(pbio_servo_set_update_divisor(srv, 4), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbio_servo_get_update_divisor(srv), ==, 4);
+
+    // While moving, the controller is updated on every loop.
+    tt_uint_op(pbio_servo_run_target(srv, 500, 180, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    count_max = 0;
+    while (!pbio_control_is_done(&srv->control)) {
+        count_max = pbio_int_math_max(count_max, srv->update_count);
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    }
+    tt_want_uint_op(count_max, ==, 0);
+
+    // While holding, it is updated on every fourth loop, and it still holds.
+    count_max = 0;
+    timer_set(&timer, 1000);
+    while (!timer_expired(&timer)) {
+        count_max = pbio_int_math_max(count_max, srv->update_count);
+        tt_want(pbio_control_is_active(&srv->control));
+        pbio_test_clock_tick(1);
+        PT_YIELD(pt);
+    }
+    tt_want_uint_op(count_max, ==, 3);
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 180, 5));
+
+    // A new command is picked up right away.
+    tt_uint_op(pbio_servo_run_target(srv, 500, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 0, 5));
+
+end:
+
+    PT_END(pt);
+}
+
+static const void *ready_source;
+static uint32_t ready_count;
+
+static void test_servo_ready_handler(const void *source) {
+    ready_source = source;
+    ready_count++;
+}
+
+static PT_THREAD(test_servo_ready_event(struct pt *pt)) {
+
+    static struct timer timer;
+    static pbio_servo_t *srv;
+    static pbdrv_legodev_dev_t *legodev;
+
+    // Start motor driver simulation process.
+    pbdrv_motor_driver_init_manual();
+
+    PT_BEGIN(pt);
+
+    // Wait for motor simulation process to be ready.
+    while (pbdrv_init_busy()) {
+        PT_YIELD(pt);
+    }
+
+    // Start motor control process manually.
+    pbio_motor_process_start();
+
+    pbdrv_legodev_type_id_t id = PBDRV_LEGODEV_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbdrv_legodev_get_device(PBIO_PORT_ID_B, &id, &legodev), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_get_servo(legodev, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    pbio_event_set_ready_handler(test_servo_ready_handler);
+
+    // No events while moving, then one on completion.
+    tt_uint_op(pbio_servo_run_angle(srv, 500, 90, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    ready_count = 0;
+    pbio_test_sleep_ms(&timer, 50);
+    tt_want_uint_op(ready_count, ==, 0);
+    pbio_test_sleep_until(pbio_control_is_done(&srv->control));
+    tt_want_uint_op(ready_count, ==, 1);
+    tt_want_ptr_op(ready_source, ==, &srv->control);
+
+    // No more events while holding.
+    pbio_test_sleep_ms(&timer, 200);
+    tt_want_uint_op(ready_count, ==, 1);
+
+    // Stopping before completion also completes the controller.
+    tt_uint_op(pbio_servo_run_angle(srv, 500, 360, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    pbio_test_sleep_ms(&timer, 50);
+    tt_uint_op(pbio_servo_stop(srv, PBIO_CONTROL_ON_COMPLETION_COAST), ==, PBIO_SUCCESS);
+    tt_want_uint_op(ready_count, ==, 2);
+
+end:
+    pbio_event_set_ready_handler(NULL);
+
+    PT_END(pt);
+}
+
 struct testcase_t pbio_servo_tests[] = {
     PBIO_PT_THREAD_TEST(test_servo_basics),
     PBIO_PT_THREAD_TEST(test_servo_stall),
     PBIO_PT_THREAD_TEST(test_servo_gearing),
+    PBIO_PT_THREAD_TEST(test_servo_update_divisor),
+    PBIO_PT_THREAD_TEST(test_servo_ready_event),
+    #if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+    PBIO_PT_THREAD_TEST(test_servo_queue),
+    #endif
     END_OF_TESTCASES
 };
@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <pbio/int_math.h>
 #include <pbio/trajectory.h>
@@ -190,6 +191,7 @@ static void get_infinite_command(uint32_t index, pbio_trajectory_command_t *c) {
 
     c->duration = DURATION_FOREVER_TICKS;
     c->speed_max = 1000 * MDEG_PER_DEG;
+    c->jerk_time = 0;
     c->continue_running = true;
 
     c->position_start = angles[index % PBIO_ARRAY_SIZE(angles)];
@@ -287,6 +289,7 @@ static const uint32_t num_position_trajectories =
 static void get_position_command(uint32_t index, pbio_trajectory_command_t *c) {
 
     c->speed_max = 1000 * MDEG_PER_DEG;
+    c->jerk_time = 0;
 
     c->continue_running = index % 2;
     index /= 2;
@@ -370,9 +373,213 @@ static void test_position_trajectory(void *env) {
     }
 }
 
+/**
+ * Checks that the acceleration of a jerk-limited phase starts and ends at
+ * zero and changes gradually in between.
+ */
+static void walk_jerk_limited_phase(pbio_trajectory_t *trj, int32_t time_start, int32_t duration, int32_t ramp_time, int32_t a_peak) {
+
+    // Nothing to check for constant acceleration phases.
+    if (ramp_time == 0) {
+        return;
+    }
+
+    const int32_t increment = 10;
+
+    // Expected acceleration change per sample, in control units, and some
+    // tolerance for rounding errors.
+    int32_t change_max = pbio_int_math_abs(a_peak) * MDEG_PER_DEG * increment / ramp_time + MDEG_PER_DEG;
+
+    pbio_trajectory_reference_t ref_prev, ref_now;
+    pbio_trajectory_get_reference(trj, trj->start.time + time_start, &ref_prev);
+    tt_want_int_op(ref_prev.acceleration, ==, 0);
+
+    for (int32_t t = increment; t < duration; t += increment) {
+        pbio_trajectory_get_reference(trj, trj->start.time + time_start + t, &ref_now);
+        tt_want(pbio_int_math_abs(ref_now.acceleration - ref_prev.acceleration) <= change_max);
+        tt_want(pbio_int_math_abs(ref_now.acceleration) <= pbio_int_math_abs(a_peak) * MDEG_PER_DEG);
+        ref_prev = ref_now;
+    }
+    tt_want(pbio_int_math_abs(ref_prev.acceleration) <= change_max);
+}
+
+/**
+ * Tests the simple trajectory with gradual acceleration changes.
+ */
+static void test_jerk_limited_trajectory(void *env) {
+
+    // Command: Same as the simple trajectory, but ramping up the acceleration
+    // in 100 ms. Each ramp takes 100 ms longer this way, during which we travel
+    // 50 degrees more, so overall expected duration is 10600 ms.
+    pbio_trajectory_command_t command = {
+        .time_start = 0,
+        .position_start = {
+            .rotations = 0,
+            .millidegrees = 0,
+        },
+        .position_end = {
+            .rotations = 27,
+            .millidegrees = 280 * MDEG_PER_DEG,
+        },
+        .speed_start = 0,
+        .speed_target = 1000 * MDEG_PER_DEG,
+        .speed_max = 1000 * MDEG_PER_DEG,
+        .acceleration = 2000 * MDEG_PER_DEG,
+        .deceleration = 2000 * MDEG_PER_DEG,
+        .jerk_time = 100 * PBIO_TRAJECTORY_TICKS_PER_MS,
+        .continue_running = false,
+    };
+
+    pbio_trajectory_t trj;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&trj, &command), ==, PBIO_SUCCESS);
+
+    tt_want_int_op(trj.t1, ==, 600 * 10);
+    tt_want_int_op(trj.t2, ==, 10000 * 10);
+    tt_want_int_op(trj.t3, ==, 10600 * 10);
+    tt_want_int_op(trj.th1, ==, 300 * MDEG_PER_DEG);
+    tt_want_int_op(trj.th2, ==, 9700 * MDEG_PER_DEG);
+    tt_want_int_op(trj.th3, ==, 10000 * MDEG_PER_DEG);
+    tt_want_int_op(trj.tj0, ==, command.jerk_time);
+    tt_want_int_op(trj.tj2, ==, command.jerk_time);
+    tt_want_int_op(trj.a0, ==, command.acceleration / MDEG_PER_DEG);
+    tt_want_int_op(trj.a2, ==, -command.deceleration / MDEG_PER_DEG);
+
+    // Halfway the first ramp, the acceleration is half of the maximum.
+    pbio_trajectory_reference_t ref;
+    pbio_trajectory_get_reference(&trj, 500, &ref);
+    tt_want_int_op(ref.acceleration, ==, command.acceleration / 2);
+
+    walk_jerk_limited_phase(&trj, 0, trj.t1, trj.tj0, trj.a0);
+    walk_jerk_limited_phase(&trj, trj.t2, trj.t3 - trj.t2, trj.tj2, trj.a2);
+    walk_trajectory(&trj);
+
+    // A short move does not reach the maximum acceleration, but still starts
+    // and ends at the commanded positions.
+    command.position_end.rotations = 0;
+    command.position_end.millidegrees = 5 * MDEG_PER_DEG;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&trj, &command), ==, PBIO_SUCCESS);
+    tt_want(trj.tj0 > 0 && trj.tj0 < (int32_t)command.jerk_time);
+    pbio_trajectory_reference_t end;
+    pbio_trajectory_get_endpoint(&trj, &end);
+    tt_want_int_op(pbio_angle_diff_mdeg(&end.position, &command.position_end), ==, 0);
+    walk_jerk_limited_phase(&trj, 0, trj.t1, trj.tj0, trj.a0);
+    walk_jerk_limited_phase(&trj, trj.t2, trj.t3 - trj.t2, trj.tj2, trj.a2);
+
+    // Timed commands keep their duration.
+    command.duration = 1000 * PBIO_TRAJECTORY_TICKS_PER_MS;
+    tt_want_int_op(pbio_trajectory_new_time_command(&trj, &command), ==, PBIO_SUCCESS);
+    tt_want_int_op(trj.t3, ==, command.duration);
+    tt_want_int_op(trj.tj0, ==, command.jerk_time);
+    walk_jerk_limited_phase(&trj, 0, trj.t1, trj.tj0, trj.a0);
+    walk_jerk_limited_phase(&trj, trj.t2, trj.t3 - trj.t2, trj.tj2, trj.a2);
+    walk_trajectory(&trj);
+}
+
+/**
+ * Tests a selection of the position trajectories with jerk limits.
+ */
+static void test_jerk_limited_position_trajectory(void *env) {
+
+    pbio_trajectory_command_t command;
+
+    // Every tenth command is enough to cover all kinds of trajectories.
+    for (uint32_t i = 0; i < num_position_trajectories; i += 10) {
+        get_position_command(i, &command);
+        command.jerk_time = 200 * PBIO_TRAJECTORY_TICKS_PER_MS;
+
+        pbio_trajectory_t trj;
+        pbio_error_t err = pbio_trajectory_new_angle_command(&trj, &command);
+        if (err == PBIO_ERROR_INVALID_ARG) {
+            continue;
+        }
+        tt_want_int_op(err, ==, PBIO_SUCCESS);
+
+        // Endpoint is the same as without jerk limits.
+        pbio_trajectory_reference_t end;
+        pbio_trajectory_get_endpoint(&trj, &end);
+        if (command.speed_target != 0) {
+            tt_want_int_op(pbio_angle_diff_mdeg(&end.position, &command.position_end), ==, 0);
+        }
+
+        walk_jerk_limited_phase(&trj, 0, trj.t1, trj.tj0, trj.a0);
+        walk_jerk_limited_phase(&trj, trj.t2, trj.t3 - trj.t2, trj.tj2, trj.a2);
+        walk_trajectory(&trj);
+    }
+}
+
+#if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+/**
+ * Tests that repeated angle commands from standstill reuse the solution of
+ * the first command, and that the result is the same as a full solve.
+ */
+static void test_trajectory_cache(void *env) {
+
+    pbio_trajectory_reset_cache();
+
+    pbio_trajectory_command_t command = {
+        .time_start = 0,
+        .position_start = {
+            .rotations = 0,
+            .millidegrees = 0,
+        },
+        .position_end = {
+            .rotations = 0,
+            .millidegrees = -90 * MDEG_PER_DEG,
+        },
+        .speed_start = 0,
+        .speed_target = 500 * MDEG_PER_DEG,
+        .speed_max = 1000 * MDEG_PER_DEG,
+        .acceleration = 2000 * MDEG_PER_DEG,
+        .deceleration = 2000 * MDEG_PER_DEG,
+        .continue_running = false,
+    };
+
+    pbio_trajectory_t first;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&first, &command), ==, PBIO_SUCCESS);
+
+    // Same relative command, but at another time and place.
+    command.time_start = 12345;
+    command.position_start.rotations = 3;
+    command.position_end.rotations = 3;
+
+    pbio_trajectory_t cached;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&cached, &command), ==, PBIO_SUCCESS);
+
+    uint32_t hits, misses;
+    pbio_trajectory_get_cache_stats(&hits, &misses);
+    tt_want_uint_op(hits, ==, 1);
+    tt_want_uint_op(misses, ==, 1);
+
+    // Starting point follows the new command, but the shape is reused.
+    tt_want_uint_op(cached.start.time, ==, command.time_start);
+    tt_want_int_op(cached.start.position.rotations, ==, 3);
+    tt_want_int_op(cached.t3, ==, first.t3);
+    tt_want_int_op(cached.th3, ==, first.th3);
+
+    // A full solve gives exactly the same result.
+    pbio_trajectory_reset_cache();
+    pbio_trajectory_t solved;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&solved, &command), ==, PBIO_SUCCESS);
+    tt_want_int_op(memcmp(&solved, &cached, sizeof(solved)), ==, 0);
+
+    // Commands that do not start from standstill are never cached.
+    command.speed_start = 100 * MDEG_PER_DEG;
+    tt_want_int_op(pbio_trajectory_new_angle_command(&solved, &command), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_trajectory_new_angle_command(&solved, &command), ==, PBIO_SUCCESS);
+    pbio_trajectory_get_cache_stats(&hits, &misses);
+    tt_want_uint_op(hits, ==, 0);
+    tt_want_uint_op(misses, ==, 1);
+}
+#endif // PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+
 struct testcase_t pbio_trajectory_tests[] = {
     PBIO_TEST(test_simple_trajectory),
     PBIO_TEST(test_position_trajectory),
     PBIO_TEST(test_infinite_trajectory),
+    PBIO_TEST(test_jerk_limited_trajectory),
+    PBIO_TEST(test_jerk_limited_position_trajectory),
+    #if PBIO_CONFIG_TRAJECTORY_CACHE_SIZE
+    PBIO_TEST(test_trajectory_cache),
+    #endif
     END_OF_TESTCASES
 };
@@ -12,6 +12,7 @@
 #include <tinytest.h>
 #include <tinytest_macros.h>
 
+#include <pbdrv/clock.h>
 #include <pbdrv/uart.h>
 #include <pbdrv/legodev.h>
 #include <pbdrv/legodev.h>
@@ -39,39 +40,58 @@ static struct {
     uint8_t *rx_msg;
     uint8_t rx_msg_length;
     pbio_error_t rx_msg_result;
+    // Bytes that have been received but not yet read.
+    uint8_t rx_data[256];
+    uint16_t rx_data_size;
+    // Lengths of the first reads completed since the last message arrived.
+    uint8_t rx_read_lengths[2];
+    uint8_t rx_num_reads;
     uint8_t *tx_msg;
     struct etimer tx_timer;
     uint8_t tx_msg_length;
     pbio_error_t tx_msg_result;
 } test_uart_dev;
 
+// Completes a pending read if enough bytes have been received.
+static void simulate_rx_complete_read(void) {
+    if (test_uart_dev.rx_msg_result != PBIO_ERROR_AGAIN || test_uart_dev.rx_data_size < test_uart_dev.rx_msg_length) {
+        return;
+    }
+    memcpy(test_uart_dev.rx_msg, test_uart_dev.rx_data, test_uart_dev.rx_msg_length);
+    test_uart_dev.rx_data_size -= test_uart_dev.rx_msg_length;
+    memmove(test_uart_dev.rx_data, &test_uart_dev.rx_data[test_uart_dev.rx_msg_length], test_uart_dev.rx_data_size);
+    test_uart_dev.rx_msg_result = PBIO_SUCCESS;
+    if (test_uart_dev.rx_num_reads < PBIO_ARRAY_SIZE(test_uart_dev.rx_read_lengths)) {
+        test_uart_dev.rx_read_lengths[test_uart_dev.rx_num_reads] = test_uart_dev.rx_msg_length;
+    }
+    test_uart_dev.rx_num_reads++;
+}
+
 PT_THREAD(simulate_rx_msg(struct pt *pt, const uint8_t *msg, uint8_t length, bool *ok)) {
     PT_BEGIN(pt);
 
-    // First uartdev reads one byte header
-    PT_WAIT_UNTIL(pt, ({
-        pbio_test_clock_tick(1);
-        test_uart_dev.rx_msg_result == PBIO_ERROR_AGAIN;
-    }));
-    tt_uint_op(test_uart_dev.rx_msg_length, ==, 1);
-    memcpy(test_uart_dev.rx_msg, msg, 1);
-    test_uart_dev.rx_msg_result = PBIO_SUCCESS;
+    // Bytes arrive all at once, as if sent at a high baud rate.
+    tt_uint_op(test_uart_dev.rx_data_size + length, <=, sizeof(test_uart_dev.rx_data));
+    memcpy(&test_uart_dev.rx_data[test_uart_dev.rx_data_size], msg, length);
+    test_uart_dev.rx_data_size += length;
+    test_uart_dev.rx_num_reads = 0;
     pbdrv_legodev_pup_uart_process_poll();
 
-    if (length == 1) {
-        *ok = true;
-        PT_EXIT(pt);
-    }
-
-    // then read rest of message
+    // Wait for uartdev to read all of them.
     PT_WAIT_UNTIL(pt, ({
         pbio_test_clock_tick(1);
-        test_uart_dev.rx_msg_result == PBIO_ERROR_AGAIN;
+        test_uart_dev.rx_data_size == 0;
     }));
-    tt_uint_op(test_uart_dev.rx_msg_length, ==, length - 1);
-    memcpy(test_uart_dev.rx_msg, &msg[1], length - 1);
-    test_uart_dev.rx_msg_result = PBIO_SUCCESS;
-    pbdrv_legodev_pup_uart_process_poll();
+
+    // During sync, uartdev reads exactly one byte header and then the rest
+    // of the message. In the data phase, it reads what is available instead.
+    if (test_uart_dev.rx_num_reads > 0) {
+        tt_uint_op(test_uart_dev.rx_read_lengths[0], ==, 1);
+        tt_uint_op(test_uart_dev.rx_num_reads, ==, length == 1 ? 1 : 2);
+        if (length > 1) {
+            tt_uint_op(test_uart_dev.rx_read_lengths[1], ==, length - 1);
+        }
+    }
 
     *ok = true;
     PT_END(pt);
@@ -698,6 +718,15 @@ static PT_THREAD(test_technic_large_motor(struct pt *pt)) {
 
     static const uint8_t msg58[] = { 0x02 }; // NACK
 
+    static const uint8_t msg59[] = {
+        0xFF, // invalid header
+        0xD4, 0x01, 0x00, 0x02, 0x00, 0x28, // mode 4, data 1, 2
+        0xD4, 0x09, 0x00, 0x09, 0x00, 0x00, // mode 4, bad checksum
+        0xD4, 0x03, 0x00, 0x04, 0x00, 0x2C, // mode 4, data 3, 4
+        0xD4, 0x05, 0x00, // first part of mode 4, data 5, 6
+    };
+    static const uint8_t msg60[] = { 0x06, 0x00, 0x28 }; // rest of mode 4, data 5, 6
+
     // used in SIMULATE_RX/TX_MSG macros
     static struct pt child;
     static bool ok;
@@ -829,6 +858,40 @@ static PT_THREAD(test_technic_large_motor(struct pt *pt)) {
     tt_want_uint_op(info->mode_info[5].data_type, ==, PBDRV_LEGODEV_DATA_TYPE_INT16);
     tt_want_uint_op(info->mode_info[5].writable, ==, 0);
 
+    // Several messages may arrive at once, possibly with corrupted bytes in
+    // between. All valid messages should be parsed, skipping the rest.
+    SIMULATE_RX_MSG(msg59);
+    int16_t *data;
+    tt_uint_op(pbdrv_legodev_get_data(legodev, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB, (void **)&data), ==, PBIO_SUCCESS);
+    tt_want_int_op(data[0], ==, 3);
+    tt_want_int_op(data[1], ==, 4);
+
+    // A message split across two reads should be parsed once complete.
+    SIMULATE_RX_MSG(msg60);
+    tt_uint_op(pbdrv_legodev_get_data(legodev, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB, (void **)&data), ==, PBIO_SUCCESS);
+    tt_want_int_op(data[0], ==, 5);
+    tt_want_int_op(data[1], ==, 6);
+    tt_want_uint_op(info->mode, ==, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB);
+
+    // The most recent samples should be kept in the order they were received,
+    // starting from the oldest one if the cursor is too old.
+    static const int16_t sample_values[] = { 0, 1, 3, 5 };
+    static uint32_t cursor;
+    cursor = 0;
+    const pbdrv_legodev_sample_t *sample;
+    for (int i = 0; i < PBIO_ARRAY_SIZE(sample_values); i++) {
+        tt_uint_op(pbdrv_legodev_get_next_sample(legodev, &cursor, &sample), ==, PBIO_SUCCESS);
+        tt_want_uint_op(sample->mode, ==, PBDRV_LEGODEV_MODE_PUP_ABS_MOTOR__CALIB);
+        tt_want_int_op(((int16_t *)sample->data)[0], ==, sample_values[i]);
+        tt_want_uint_op(sample->time, <=, pbdrv_clock_get_ms());
+    }
+    tt_uint_op(pbdrv_legodev_get_next_sample(legodev, &cursor, &sample), ==, PBIO_ERROR_AGAIN);
+
+    // New samples are returned from where the cursor left off.
+    SIMULATE_RX_MSG(msg57);
+    tt_uint_op(pbdrv_legodev_get_next_sample(legodev, &cursor, &sample), ==, PBIO_SUCCESS);
+    tt_want_int_op(((int16_t *)sample->data)[0], ==, 0);
+    tt_uint_op(pbdrv_legodev_get_next_sample(legodev, &cursor, &sample), ==, PBIO_ERROR_AGAIN);
 
     PT_YIELD(pt);
 
@@ -1079,6 +1142,8 @@ pbio_error_t pbdrv_uart_read_begin(pbdrv_uart_dev_t *uart, uint8_t *msg, uint8_t
 pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart) {
     assert(test_uart_dev.rx_msg);
 
+    simulate_rx_complete_read();
+
     if (test_uart_dev.rx_msg_result == PBIO_ERROR_AGAIN && etimer_expired(&test_uart_dev.rx_timer)) {
         test_uart_dev.rx_msg_result = PBIO_ERROR_TIMEDOUT;
     }
@@ -1090,6 +1155,16 @@ pbio_error_t pbdrv_uart_read_end(pbdrv_uart_dev_t *uart) {
     return test_uart_dev.rx_msg_result;
 }
 
+uint8_t pbdrv_uart_read_available(pbdrv_uart_dev_t *uart, uint8_t *buf, uint8_t size) {
+    assert(!test_uart_dev.rx_msg);
+
+    uint8_t count = test_uart_dev.rx_data_size < size ? test_uart_dev.rx_data_size : size;
+    memcpy(buf, test_uart_dev.rx_data, count);
+    test_uart_dev.rx_data_size -= count;
+    memmove(test_uart_dev.rx_data, &test_uart_dev.rx_data[count], test_uart_dev.rx_data_size);
+    return count;
+}
+
 void pbdrv_uart_read_cancel(pbdrv_uart_dev_t *uart) {
 
 }
@@ -63,9 +63,18 @@ static void test_oneshot(void *env) {
     tt_want(pbio_oneshot(true, &test_oneshot));
 }
 
+static void test_crc32(void *env) {
+    static const uint8_t data[] = "123456789";
+
+    // Standard check values for CRC-32.
+    tt_want_int_op(pbio_crc32(data, 0), ==, 0);
+    tt_want_int_op(pbio_crc32(data, 9), ==, 0xCBF43926);
+}
+
 struct testcase_t pbio_util_tests[] = {
     PBIO_TEST(test_uuid128_reverse_compare),
     PBIO_TEST(test_uuid128_reverse_copy),
     PBIO_TEST(test_oneshot),
+    PBIO_TEST(test_crc32),
     END_OF_TESTCASES
 };
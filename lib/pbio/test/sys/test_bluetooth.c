@@ -9,8 +9,10 @@
 #include <tinytest_macros.h>
 #include <tinytest.h>
 
+#include <pbio/protocol.h>
 #include <pbio/util.h>
 #include <pbsys/bluetooth.h>
+#include <pbsys/command.h>
 #include <pbsys/main.h>
 #include <pbsys/status.h>
 #include <test-pbio.h>
@@ -106,7 +108,41 @@ static PT_THREAD(test_bluetooth(struct pt *pt)) {
     PT_END(pt);
 }
 
+static pbio_pybricks_error_t read_user_ram_checksums(uint32_t offset, uint32_t size, uint8_t count) {
+    uint8_t cmd[10];
+    cmd[0] = PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS;
+    pbio_set_uint32_le(&cmd[1], offset);
+    pbio_set_uint32_le(&cmd[5], size);
+    cmd[9] = count;
+    return pbsys_command(cmd, sizeof(cmd));
+}
+
+static void test_user_ram_checksums(void *env) {
+    static const uint8_t short_cmd[] = { PBIO_PYBRICKS_COMMAND_READ_USER_RAM_CHECKSUMS, 0, 0, 0, 0 };
+
+    // Incomplete requests are rejected.
+    tt_want_uint_op(pbsys_command(short_cmd, sizeof(short_cmd)), ==, PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED);
+
+    // Number of blocks must be in range.
+    tt_want_uint_op(read_user_ram_checksums(0, 16, 0), ==, PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED);
+    tt_want_uint_op(read_user_ram_checksums(0, 16, PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX + 1), ==, PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED);
+
+    // Total size is limited so the command handler does not block for long.
+    tt_want_uint_op(read_user_ram_checksums(0, PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE + 1, 1), ==, PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED);
+    tt_want_uint_op(read_user_ram_checksums(0, PBIO_PYBRICKS_USER_RAM_CHECKSUMS_MAX_SIZE / 2 + 1, 2), ==, PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED);
+
+    // User RAM can't be read while a program is running.
+    pbsys_status_set(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING);
+    tt_want_uint_op(read_user_ram_checksums(0, 16, 1), ==, PBIO_PYBRICKS_ERROR_BUSY);
+    pbsys_status_clear(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING);
+
+    // Valid requests get through to program loading, which this platform
+    // does not have.
+    tt_want_uint_op(read_user_ram_checksums(0, 16, 1), ==, PBIO_PYBRICKS_ERROR_INVALID_COMMAND);
+}
+
 struct testcase_t pbsys_bluetooth_tests[] = {
     PBIO_PT_THREAD_TEST(test_bluetooth),
+    PBIO_TEST(test_user_ram_checksums),
     END_OF_TESTCASES
 };
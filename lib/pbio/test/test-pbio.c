@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -16,6 +17,7 @@
 #include <contiki.h>
 
 #include "src/processes.h"
+#include "test-pbio.h"
 
 #define PBIO_TEST_TIMEOUT 1 // seconds
 
@@ -86,6 +88,9 @@ extern struct testcase_t pbio_light_animation_tests[];
 extern struct testcase_t pbio_color_light_tests[];
 extern struct testcase_t pbio_light_matrix_tests[];
 extern struct testcase_t pbio_int_math_tests[];
+extern struct testcase_t pbio_logger_tests[];
+extern struct testcase_t pbio_motion_group_tests[];
+extern struct testcase_t pbio_observer_tests[];
 extern struct testcase_t pbio_servo_tests[];
 extern struct testcase_t pbio_task_tests[];
 extern struct testcase_t pbio_trajectory_tests[];
@@ -103,7 +108,10 @@ static struct testgroup_t test_groups[] = {
     { "src/light/", pbio_light_animation_tests },
     { "src/light/", pbio_color_light_tests },
     { "src/light/", pbio_light_matrix_tests },
+    { "src/logger/", pbio_logger_tests },
     { "src/math/", pbio_int_math_tests },
+    { "src/motion_group/", pbio_motion_group_tests },
+    { "src/observer/", pbio_observer_tests },
     { "src/servo/", pbio_servo_tests },
     { "src/task/", pbio_task_tests, },
     { "src/trajectory/", pbio_trajectory_tests },
@@ -115,6 +123,13 @@ static struct testgroup_t test_groups[] = {
 };
 
 int main(int argc, const char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return pbio_test_bench_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0) {
+        return pbio_test_replay_main(argc - 1, argv + 1);
+    }
+
     const char *results_dir = getenv("PBIO_TEST_RESULTS_DIR");
     if (results_dir) {
         if (chdir(results_dir) == -1) {
@@ -20,6 +20,12 @@
 void pbio_test_run_thread(void *env);
 extern struct testcase_setup_t pbio_test_setup;
 
+// runs the benchmarks instead of the tests, see bench/bench-pbio.c
+int pbio_test_bench_main(int argc, const char **argv);
+
+// replays a servo log instead of running the tests, see replay/replay-pbio.c
+int pbio_test_replay_main(int argc, const char **argv);
+
 // these can be used by tests that use the bluetooth driver
 
 bool pbio_test_bluetooth_is_advertising_enabled(void);
@@ -219,6 +219,25 @@ STATIC mp_obj_t pb_type_Control_stall_tolerances(size_t n_args, const mp_obj_t *
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Control_stall_tolerances_obj, 1, pb_type_Control_stall_tolerances);
 
+// pybricks._common.Control.jerk_time
+STATIC mp_obj_t pb_type_Control_jerk_time(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Control_obj_t, self,
+        PB_ARG_DEFAULT_NONE(time));
+
+    // If no value is given, return current value
+    if (time_in == mp_const_none) {
+        return mp_obj_new_int_from_uint(pbio_control_settings_get_jerk_time(&self->control->settings));
+    }
+
+    // Set user setting
+    pb_assert(pbio_control_settings_set_jerk_time(&self->control->settings, pb_obj_get_positive_int(time_in)));
+
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Control_jerk_time_obj, 1, pb_type_Control_jerk_time);
+
 // pybricks._common.Control.trajectory
 STATIC mp_obj_t pb_type_Control_trajectory(mp_obj_t self_in) {
     pb_type_Control_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -294,6 +313,7 @@ STATIC const mp_rom_map_elem_t pb_type_Control_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pid), MP_ROM_PTR(&pb_type_Control_pid_obj) },
     { MP_ROM_QSTR(MP_QSTR_target_tolerances), MP_ROM_PTR(&pb_type_Control_target_tolerances_obj) },
     { MP_ROM_QSTR(MP_QSTR_stall_tolerances), MP_ROM_PTR(&pb_type_Control_stall_tolerances_obj) },
+    { MP_ROM_QSTR(MP_QSTR_jerk_time), MP_ROM_PTR(&pb_type_Control_jerk_time_obj) },
     { MP_ROM_QSTR(MP_QSTR_trajectory), MP_ROM_PTR(&pb_type_Control_trajectory_obj) },
     { MP_ROM_QSTR(MP_QSTR_done), MP_ROM_PTR(&pb_type_Control_done_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&pb_type_Control_load_obj) },
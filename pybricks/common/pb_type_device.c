@@ -57,6 +57,14 @@ void *pb_type_device_get_data_blocking(mp_obj_t self_in, uint8_t mode) {
     return data;
 }
 
+// LEGO UART devices post a ready event when they are ready after a mode
+// switch or setting data, so awaitables need not poll them.
+#if PBDRV_CONFIG_LEGODEV_PUP_UART
+#define PB_TYPE_DEVICE_EVENT_SOURCE(sensor) ((sensor)->legodev)
+#else
+#define PB_TYPE_DEVICE_EVENT_SOURCE(sensor) pb_type_awaitable_event_source_none
+#endif
+
 STATIC bool pb_pup_device_test_completion(mp_obj_t self_in, uint32_t end_time) {
     pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(self_in);
     pbio_error_t err = pbdrv_legodev_is_ready(sensor->legodev);
@@ -80,6 +88,7 @@ mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw
         sensor_in,
         sensor->awaitables,
         pb_type_awaitable_end_time_none,
+        PB_TYPE_DEVICE_EVENT_SOURCE(sensor),
         pb_pup_device_test_completion,
         method->get_values,
         pb_type_awaitable_cancel_none,
@@ -98,6 +107,7 @@ mp_obj_t pb_type_device_set_data(pb_type_device_obj_base_t *sensor, uint8_t mode
         MP_OBJ_FROM_PTR(sensor),
         sensor->awaitables,
         pb_type_awaitable_end_time_none,
+        PB_TYPE_DEVICE_EVENT_SOURCE(sensor),
         pb_pup_device_test_completion,
         pb_type_awaitable_return_none,
         pb_type_awaitable_cancel_none,
@@ -16,6 +16,8 @@
 #include <pbio/servo.h>
 
 #include "py/obj.h"
+#include "py/objlist.h"
+#include "py/objtuple.h"
 #include "py/runtime.h"
 #include "py/mpconfig.h"
 
@@ -37,9 +39,10 @@ typedef struct _tools_Logger_obj_t {
      */
     int32_t *buf;
     /**
-     * Number of columns, needed when starting log which happens after object creation.
+     * Number of values per row given by the control loop, needed when
+     * starting log which happens after object creation.
      */
-    uint8_t num_cols;
+    uint8_t num_values;
     /**
      * Buffer size. Used to free (renew) old data when resetting logger.
      */
@@ -50,19 +53,45 @@ STATIC mp_obj_t tools_Logger_start(size_t n_args, const mp_obj_t *pos_args, mp_m
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         tools_Logger_obj_t, self,
         PB_ARG_REQUIRED(duration),
-        PB_ARG_DEFAULT_INT(down_sample, 1));
+        PB_ARG_DEFAULT_INT(down_sample, 1),
+        PB_ARG_DEFAULT_FALSE(stream),
+        PB_ARG_DEFAULT_NONE(columns));
+
+    // Select which values to log. Column numbers are as in the saved log,
+    // where column 0 is the log time which is always included.
+    uint32_t columns = PBIO_LOGGER_COLUMNS_ALL(self->num_values);
+    if (columns_in != mp_const_none) {
+        size_t num_selected;
+        mp_obj_t *selected;
+        mp_obj_get_array(columns_in, &num_selected, &selected);
+        columns = 0;
+        for (size_t i = 0; i < num_selected; i++) {
+            mp_int_t column = pb_obj_get_int(selected[i]);
+            if (column < PBIO_LOGGER_NUM_DEFAULT_COLS || column >= PBIO_LOGGER_NUM_DEFAULT_COLS + self->num_values) {
+                pb_assert(PBIO_ERROR_INVALID_ARG);
+            }
+            columns |= 1UL << (column - PBIO_LOGGER_NUM_DEFAULT_COLS);
+        }
+    }
+
+    // In streaming mode, duration sets how much can be buffered before the
+    // application must read it. Otherwise it is the total logging duration.
 
     // Log only one row per divisor samples.
     mp_uint_t down_sample = pbio_int_math_max(pb_obj_get_int(down_sample_in), 1);
     mp_uint_t num_rows = pb_obj_get_int(duration_in) / PBIO_CONFIG_CONTROL_LOOP_TIME_MS / down_sample;
 
     // Size is number of rows times column width. All data are int32.
-    mp_int_t size = num_rows * self->num_cols;
+    mp_int_t size = num_rows * pbio_logger_get_num_cols(columns);
     self->buf = m_renew(int32_t, self->buf, self->last_size, size);
     self->last_size = size;
 
     // Indicates that background control loops may enter data in log.
-    pbio_logger_start(self->log, self->buf, num_rows, self->num_cols, down_sample);
+    if (mp_obj_is_true(stream_in)) {
+        pbio_logger_start_stream(self->log, self->buf, num_rows, columns, down_sample);
+    } else {
+        pbio_logger_start(self->log, self->buf, num_rows, columns, down_sample);
+    }
 
     return mp_const_none;
 }
@@ -78,21 +107,117 @@ STATIC mp_obj_t tools_Logger_stop(mp_obj_t self_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(tools_Logger_stop_obj, tools_Logger_stop);
 
+STATIC mp_obj_t tools_Logger_read(mp_obj_t self_in) {
+    tools_Logger_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Take a snapshot of the number of rows. The control loop may add more
+    // rows while we read these, but it never modifies rows we have not
+    // consumed yet.
+    uint32_t num_rows = pbio_logger_get_num_rows_used(self->log);
+
+    mp_obj_list_t *rows = MP_OBJ_TO_PTR(mp_obj_new_list(num_rows, NULL));
+    for (uint32_t row = 0; row < num_rows; row++) {
+        int32_t *row_data = pbio_logger_get_row_data(self->log, row);
+        mp_obj_tuple_t *values = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->log->num_cols, NULL));
+        for (uint32_t col = 0; col < self->log->num_cols; col++) {
+            values->items[col] = mp_obj_new_int(row_data[col]);
+        }
+        rows->items[row] = MP_OBJ_FROM_PTR(values);
+    }
+
+    // Release the rows so the control loop can write new data in their place.
+    pbio_logger_consume_rows(self->log, num_rows);
+
+    return MP_OBJ_FROM_PTR(rows);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(tools_Logger_read_obj, tools_Logger_read);
+
+/**
+ * Number of bytes written at once in binary mode. Without a real file, this
+ * is printed as one line of base64 text, which is 76 characters.
+ */
+#define LOGGER_CHUNK_SIZE (57)
+
+/**
+ * Buffered writer for binary log data.
+ */
+typedef struct _tools_Logger_writer_t {
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    FILE *file;
+    #endif
+    uint8_t data[LOGGER_CHUNK_SIZE];
+    size_t size;
+    pbio_error_t err;
+} tools_Logger_writer_t;
+
+#if !PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+STATIC const char tools_Logger_base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+#endif
+
+STATIC void tools_Logger_writer_flush(tools_Logger_writer_t *writer) {
+    if (writer->size == 0) {
+        return;
+    }
+
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    if (fwrite(writer->data, 1, writer->size, writer->file) != writer->size) {
+        writer->err = PBIO_ERROR_IO;
+    }
+    #else
+    // Stdout is a text stream, so print data as a line of base64 text.
+    char line[LOGGER_CHUNK_SIZE / 3 * 4 + 1];
+    size_t len = 0;
+    for (size_t i = 0; i < writer->size; i += 3) {
+        uint32_t group = writer->data[i] << 16;
+        if (i + 1 < writer->size) {
+            group |= writer->data[i + 1] << 8;
+        }
+        if (i + 2 < writer->size) {
+            group |= writer->data[i + 2];
+        }
+        line[len++] = tools_Logger_base64_table[(group >> 18) & 0x3f];
+        line[len++] = tools_Logger_base64_table[(group >> 12) & 0x3f];
+        line[len++] = i + 1 < writer->size ? tools_Logger_base64_table[(group >> 6) & 0x3f] : '=';
+        line[len++] = i + 2 < writer->size ? tools_Logger_base64_table[group & 0x3f] : '=';
+    }
+    line[len++] = '\n';
+    mp_print_strn(&mp_plat_print, line, len, 0, 0, 0);
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+
+    writer->size = 0;
+
+    // Writing data can take a while, so give system some time too.
+    MICROPY_VM_HOOK_LOOP
+    mp_handle_pending(true);
+}
+
+STATIC void tools_Logger_writer_write(tools_Logger_writer_t *writer, const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        writer->data[writer->size++] = data[i];
+        if (writer->size == LOGGER_CHUNK_SIZE) {
+            tools_Logger_writer_flush(writer);
+        }
+    }
+}
+
 STATIC mp_obj_t tools_Logger_save(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         tools_Logger_obj_t, self,
-        PB_ARG_DEFAULT_NONE(path));
+        PB_ARG_DEFAULT_NONE(path),
+        PB_ARG_DEFAULT_FALSE(binary));
 
     // Don't allow any more data to be added to logs.
     pbio_logger_stop(self->log);
 
+    bool binary = mp_obj_is_true(binary_in);
+
     // Get log file path.
-    const char *path = path_in == mp_const_none ? "log.txt" : mp_obj_str_get_str(path_in);
+    const char *path = path_in != mp_const_none ? mp_obj_str_get_str(path_in) : (binary ? "log.bin" : "log.txt");
 
     #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
     // Create an empty log file locally.
-    FILE *log_file = fopen(path, "w");
+    FILE *log_file = fopen(path, binary ? "wb" : "w");
     if (log_file == NULL) {
         pb_assert(PBIO_ERROR_IO);
     }
@@ -104,31 +229,60 @@ STATIC mp_obj_t tools_Logger_save(size_t n_args, const mp_obj_t *pos_args, mp_ma
 
     pbio_error_t err = PBIO_SUCCESS;
 
-    // Write data to file line by line
-    for (uint32_t row = 0; row < pbio_logger_get_num_rows_used(self->log); row++) {
+    if (binary) {
+        // Binary data is buffered and written in chunks, which is much faster
+        // than formatting each value. It can be decoded with tools/decode_log.py.
+        tools_Logger_writer_t writer = {
+            #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+            .file = log_file,
+            #endif
+            .err = PBIO_SUCCESS,
+        };
 
-        int32_t *row_data = pbio_logger_get_row_data(self->log, row);
+        size_t encoded_max = PBIO_LOGGER_BINARY_HEADER_SIZE + self->log->num_cols * PBIO_LOGGER_VARINT_SIZE_MAX;
+        uint8_t *encoded = m_new(uint8_t, encoded_max);
 
-        for (uint32_t col = 0; col < self->log->num_cols; col++) {
+        size_t size = pbio_logger_encode_header(self->log, encoded);
+        tools_Logger_writer_write(&writer, encoded, size);
 
-            // Write "-12345, " or "-12345\n" for last value on row.
-            const char *format = col + 1 < self->log->num_cols ? "%d, " : "%d\n";
+        for (uint32_t row = 0; row < pbio_logger_get_num_rows_used(self->log) && writer.err == PBIO_SUCCESS; row++) {
+            size = pbio_logger_encode_row(self->log, row, encoded);
+            tools_Logger_writer_write(&writer, encoded, size);
+        }
+        tools_Logger_writer_flush(&writer);
 
-            // Write one value.
-            #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
-            if (fprintf(log_file, format, row_data[col]) < 0) {
-                break;
+        m_del(uint8_t, encoded, encoded_max);
+        err = writer.err;
+    } else {
+        // Write data to file line by line
+        for (uint32_t row = 0; row < pbio_logger_get_num_rows_used(self->log); row++) {
+
+            int32_t *row_data = pbio_logger_get_row_data(self->log, row);
+
+            for (uint32_t col = 0; col < self->log->num_cols; col++) {
+
+                // Write "-12345, " or "-12345\n" for last value on row.
+                const char *format = col + 1 < self->log->num_cols ? "%d, " : "%d\n";
+
+                // Write one value.
+                #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+                if (fprintf(log_file, format, row_data[col]) < 0) {
+                    break;
+                }
+                #else
+                mp_printf(&mp_plat_print, format, row_data[col]);
+                #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
             }
-            #else
-            mp_printf(&mp_plat_print, format, row_data[col]);
-            #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
-        }
 
-        // Writing data can take a while, so give system some time too.
-        MICROPY_VM_HOOK_LOOP
-        mp_handle_pending(true);
+            // Writing data can take a while, so give system some time too.
+            MICROPY_VM_HOOK_LOOP
+            mp_handle_pending(true);
+        }
     }
 
+    // In streaming mode, saved rows are released like rows that are read.
+    pbio_logger_consume_rows(self->log, pbio_logger_get_num_rows_used(self->log));
+
     #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
     // Close the file
     if (fclose(log_file) != 0) {
@@ -147,6 +301,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_KW(tools_Logger_save_obj, 1, tools_Logger_save);
 STATIC const mp_rom_map_elem_t tools_Logger_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&tools_Logger_start_obj) },
     { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&tools_Logger_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&tools_Logger_read_obj) },
     { MP_ROM_QSTR(MP_QSTR_save), MP_ROM_PTR(&tools_Logger_save_obj) },
 };
 STATIC MP_DEFINE_CONST_DICT(tools_Logger_locals_dict, tools_Logger_locals_dict_table);
@@ -160,7 +315,7 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(tools_Logger_type,
 mp_obj_t common_Logger_obj_make_new(pbio_log_t *log, uint8_t num_values) {
     tools_Logger_obj_t *logger = mp_obj_malloc(tools_Logger_obj_t, &tools_Logger_type);
     logger->log = log;
-    logger->num_cols = num_values + PBIO_LOGGER_NUM_DEFAULT_COLS;
+    logger->num_values = num_values;
     return MP_OBJ_FROM_PTR(logger);
 }
 
@@ -276,6 +276,7 @@ STATIC mp_obj_t await_or_wait(pb_type_Motor_obj_t *self) {
         MP_OBJ_FROM_PTR(self),
         self->device_base.awaitables,
         pb_type_awaitable_end_time_none,
+        &self->srv->control,
         pb_type_Motor_test_completion,
         pb_type_awaitable_return_none,
         pb_type_Motor_cancel,
@@ -347,6 +348,7 @@ STATIC mp_obj_t pb_type_Motor_run_until_stalled(size_t n_args, const mp_obj_t *p
         MP_OBJ_FROM_PTR(self),
         self->device_base.awaitables,
         pb_type_awaitable_end_time_none,
+        &self->srv->control,
         pb_type_Motor_test_completion,
         pb_type_Motor_stall_return_value,
         pb_type_Motor_cancel,
@@ -404,6 +406,33 @@ STATIC mp_obj_t pb_type_Motor_run_target(size_t n_args, const mp_obj_t *pos_args
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_run_target_obj, 1, pb_type_Motor_run_target);
 
+#if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+// pybricks.common.Motor.queue_target
+STATIC mp_obj_t pb_type_Motor_queue_target(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_Motor_obj_t, self,
+        PB_ARG_REQUIRED(speed),
+        PB_ARG_REQUIRED(target_angle),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_FALSE(wait));
+
+    mp_int_t speed = pb_obj_get_int(speed_in);
+    mp_int_t target_angle = pb_obj_get_int(target_angle_in);
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    // Queue behind the ongoing maneuver. The motor process starts it later.
+    pb_assert(pbio_servo_queue_target(self->srv, speed, target_angle, then));
+
+    // By default, return right away so more targets can be queued.
+    if (!mp_obj_is_true(wait_in)) {
+        return mp_const_none;
+    }
+    // Otherwise, wait until all queued targets are reached.
+    return await_or_wait(self);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_queue_target_obj, 1, pb_type_Motor_queue_target);
+#endif // PBIO_CONFIG_CONTROL_QUEUE_SIZE
+
 // pybricks.common.Motor.track_target
 STATIC mp_obj_t pb_type_Motor_track_target(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
@@ -480,6 +509,9 @@ STATIC const mp_rom_map_elem_t pb_type_Motor_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_run_until_stalled), MP_ROM_PTR(&pb_type_Motor_run_until_stalled_obj) },
     { MP_ROM_QSTR(MP_QSTR_run_angle), MP_ROM_PTR(&pb_type_Motor_run_angle_obj) },
     { MP_ROM_QSTR(MP_QSTR_run_target), MP_ROM_PTR(&pb_type_Motor_run_target_obj) },
+    #if PBIO_CONFIG_CONTROL_QUEUE_SIZE
+    { MP_ROM_QSTR(MP_QSTR_queue_target), MP_ROM_PTR(&pb_type_Motor_queue_target_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_stalled), MP_ROM_PTR(&pb_type_Motor_stalled_obj) },
     { MP_ROM_QSTR(MP_QSTR_done), MP_ROM_PTR(&pb_type_Motor_done_obj) },
     { MP_ROM_QSTR(MP_QSTR_track_target), MP_ROM_PTR(&pb_type_Motor_track_target_obj) },
@@ -163,6 +163,7 @@ STATIC mp_obj_t pb_type_Speaker_beep(size_t n_args, const mp_obj_t *pos_args, mp
         MP_OBJ_FROM_PTR(self),
         self->awaitables,
         pb_type_awaitable_end_time_none,
+        pb_type_awaitable_event_source_none,
         pb_type_Speaker_beep_test_completion,
         pb_type_awaitable_return_none,
         pb_type_Speaker_cancel,
@@ -379,6 +380,7 @@ STATIC mp_obj_t pb_type_Speaker_play_notes(size_t n_args, const mp_obj_t *pos_ar
         MP_OBJ_FROM_PTR(self),
         self->awaitables,
         pb_type_awaitable_end_time_none,
+        pb_type_awaitable_event_source_none,
         pb_type_Speaker_notes_test_completion,
         pb_type_awaitable_return_none,
         pb_type_Speaker_cancel,
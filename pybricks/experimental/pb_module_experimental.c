@@ -11,6 +11,7 @@
 #include "py/runtime.h"
 #include "py/mperrno.h"
 
+#include <pbio/motor_process.h>
 #include <pbio/util.h>
 
 #include <pybricks/util_mp/pb_obj_helper.h>
@@ -19,6 +20,7 @@
 #include <pybricks/util_pb/pb_error.h>
 
 #include <pybricks/robotics.h>
+#include <pybricks/tools.h>
 
 #if PYBRICKS_HUB_EV3BRICK
 #if !MICROPY_MODULE_BUILTIN_INIT
@@ -92,6 +94,73 @@ STATIC mp_obj_t experimental_hello_world(size_t n_args, const mp_obj_t *pos_args
 // See also experimental_globals_table below. This function object is added there to make it importable.
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(experimental_hello_world_obj, 0, experimental_hello_world);
 
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+STATIC mp_obj_t experimental_histogram_new(const pbio_motor_process_histogram_t *histogram) {
+    mp_obj_t bins[PBIO_MOTOR_PROCESS_STATS_NUM_BINS];
+    for (size_t i = 0; i < PBIO_MOTOR_PROCESS_STATS_NUM_BINS; i++) {
+        bins[i] = mp_obj_new_int_from_uint(histogram->bins[i]);
+    }
+    mp_obj_t ret[] = {
+        mp_obj_new_tuple(MP_ARRAY_SIZE(bins), bins),
+        mp_obj_new_int_from_uint(histogram->max),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+
+// pybricks.experimental.motor_process_stats
+STATIC mp_obj_t experimental_motor_process_stats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
+        PB_ARG_DEFAULT_FALSE(reset));
+
+    // Returns a dictionary of the control loop timing statistics. All
+    // histograms are a tuple of bin counts and the maximum in microseconds.
+    // The first bin counts values below 32 us, and each next bin is twice as
+    // wide. The last bin counts all longer durations.
+    const pbio_motor_process_stats_t *stats = pbio_motor_process_get_stats();
+
+    mp_obj_t dict = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_updates), mp_obj_new_int_from_uint(stats->num_updates));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_overruns), mp_obj_new_int_from_uint(stats->num_overruns));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_jitter), experimental_histogram_new(&stats->jitter));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_battery), experimental_histogram_new(&stats->battery));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_drivebase), experimental_histogram_new(&stats->drivebase));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_servo), experimental_histogram_new(&stats->servo));
+
+    if (mp_obj_is_true(reset_in)) {
+        pbio_motor_process_reset_stats();
+    }
+
+    return dict;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(experimental_motor_process_stats_obj, 0, experimental_motor_process_stats);
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+#if PYBRICKS_PY_TOOLS
+// pybricks.experimental.run_task_stats
+STATIC mp_obj_t experimental_run_task_stats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
+        PB_ARG_DEFAULT_FALSE(reset));
+
+    // Returns a dictionary of the garbage collection statistics of the
+    // run_task loop. All times are in microseconds.
+    const pb_module_tools_run_task_stats_t *stats = pb_module_tools_run_task_get_stats();
+
+    mp_obj_t dict = mp_obj_new_dict(5);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_iterations), mp_obj_new_int_from_uint(stats->num_iterations));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_collections), mp_obj_new_int_from_uint(stats->num_collections));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_gc_time), mp_obj_new_int_from_uint(stats->gc_time_last));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_gc_time_max), mp_obj_new_int_from_uint(stats->gc_time_max));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_gc_time_total), mp_obj_new_int_from_uint(stats->gc_time_total));
+
+    if (mp_obj_is_true(reset_in)) {
+        pb_module_tools_run_task_reset_stats();
+    }
+
+    return dict;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(experimental_run_task_stats_obj, 0, experimental_run_task_stats);
+#endif // PYBRICKS_PY_TOOLS
+
 STATIC const mp_rom_map_elem_t experimental_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_experimental) },
     #if PYBRICKS_HUB_EV3BRICK
@@ -99,6 +168,12 @@ STATIC const mp_rom_map_elem_t experimental_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pthread_raise), MP_ROM_PTR(&mod_experimental_pthread_raise_obj) },
     #endif // PYBRICKS_HUB_EV3BRICK
     { MP_ROM_QSTR(MP_QSTR_hello_world), MP_ROM_PTR(&experimental_hello_world_obj) },
+    #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+    { MP_ROM_QSTR(MP_QSTR_motor_process_stats), MP_ROM_PTR(&experimental_motor_process_stats_obj) },
+    #endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+    #if PYBRICKS_PY_TOOLS
+    { MP_ROM_QSTR(MP_QSTR_run_task_stats), MP_ROM_PTR(&experimental_run_task_stats_obj) },
+    #endif // PYBRICKS_PY_TOOLS
 };
 STATIC MP_DEFINE_CONST_DICT(pb_module_experimental_globals, experimental_globals_table);
 
@@ -31,6 +31,10 @@ typedef struct _iodevices_PUPDevice_obj_t {
     uint8_t last_mode;
     // ID of a passive device, if any.
     pbdrv_legodev_type_id_t passive_id;
+    #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+    // Number of samples read with read_samples().
+    uint32_t sample_cursor;
+    #endif
 } iodevices_PUPDevice_obj_t;
 
 /**
@@ -109,17 +113,20 @@ STATIC mp_obj_t iodevices_PUPDevice_info(mp_obj_t self_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_info_obj, iodevices_PUPDevice_info);
 
-STATIC mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
-    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    void *data = pb_type_device_get_data(self_in, self->last_mode);
-
-    pbdrv_legodev_info_t *info;
-    pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
+/**
+ * Converts raw device data to a tuple of values.
+ *
+ * @param [in]  info        The device information.
+ * @param [in]  mode        Mode of the data.
+ * @param [in]  data        The raw data.
+ * @return                  Tuple of values.
+ */
+STATIC mp_obj_t pup_data_to_tuple(pbdrv_legodev_info_t *info, uint8_t mode, void *data) {
 
     mp_obj_t values[PBDRV_LEGODEV_MAX_DATA_SIZE];
 
-    for (uint8_t i = 0; i < info->mode_info[info->mode].num_values; i++) {
-        switch (info->mode_info[info->mode].data_type) {
+    for (uint8_t i = 0; i < info->mode_info[mode].num_values; i++) {
+        switch (info->mode_info[mode].data_type) {
             case PBDRV_LEGODEV_DATA_TYPE_INT8:
                 values[i] = mp_obj_new_int(((int8_t *)data)[i]);
                 break;
@@ -139,7 +146,17 @@ STATIC mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
         }
     }
 
-    return mp_obj_new_tuple(info->mode_info[info->mode].num_values, values);
+    return mp_obj_new_tuple(info->mode_info[mode].num_values, values);
+}
+
+STATIC mp_obj_t get_pup_data_tuple(mp_obj_t self_in) {
+    iodevices_PUPDevice_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    void *data = pb_type_device_get_data(self_in, self->last_mode);
+
+    pbdrv_legodev_info_t *info;
+    pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
+
+    return pup_data_to_tuple(info, info->mode, data);
 }
 
 // pybricks.iodevices.PUPDevice.read
@@ -166,6 +183,49 @@ STATIC mp_obj_t iodevices_PUPDevice_read(size_t n_args, const mp_obj_t *pos_args
 }
 MP_DEFINE_CONST_FUN_OBJ_KW(iodevices_PUPDevice_read_obj, 1, iodevices_PUPDevice_read);
 
+#if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+// pybricks.iodevices.PUPDevice.read_samples
+STATIC mp_obj_t iodevices_PUPDevice_read_samples(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        iodevices_PUPDevice_obj_t, self,
+        PB_ARG_REQUIRED(mode));
+
+    // Passive devices don't support reading.
+    if (self->passive_id != PBDRV_LEGODEV_TYPE_ID_LPF2_UNKNOWN_UART) {
+        pb_assert(PBIO_ERROR_INVALID_OP);
+    }
+
+    // Start switching to the requested mode. Until the device sends data in
+    // this mode, there are no samples to return. The same goes if it is still
+    // busy switching to another mode.
+    uint8_t mode = mp_obj_get_int(mode_in);
+    pbio_error_t err = pbdrv_legodev_set_mode(self->device_base.legodev, mode);
+    if (err == PBIO_ERROR_AGAIN) {
+        return mp_obj_new_list(0, NULL);
+    }
+    pb_assert(err);
+
+    pbdrv_legodev_info_t *info;
+    pb_assert(pbdrv_legodev_get_info(self->device_base.legodev, &info));
+
+    // Return (time, values) of all samples in this mode since the last call.
+    mp_obj_t samples = mp_obj_new_list(0, NULL);
+    const pbdrv_legodev_sample_t *sample;
+    while (pbdrv_legodev_get_next_sample(self->device_base.legodev, &self->sample_cursor, &sample) == PBIO_SUCCESS) {
+        if (sample->mode != mode) {
+            continue;
+        }
+        mp_obj_t entry[] = {
+            mp_obj_new_int_from_uint(sample->time),
+            pup_data_to_tuple(info, mode, (void *)sample->data),
+        };
+        mp_obj_list_append(samples, mp_obj_new_tuple(MP_ARRAY_SIZE(entry), entry));
+    }
+    return samples;
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(iodevices_PUPDevice_read_samples_obj, 1, iodevices_PUPDevice_read_samples);
+#endif // PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+
 // pybricks.iodevices.PUPDevice.write
 STATIC mp_obj_t iodevices_PUPDevice_write(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
@@ -232,6 +292,9 @@ MP_DEFINE_CONST_FUN_OBJ_KW(iodevices_PUPDevice_write_obj, 1, iodevices_PUPDevice
 // dir(pybricks.iodevices.PUPDevice)
 STATIC const mp_rom_map_elem_t iodevices_PUPDevice_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_read),       MP_ROM_PTR(&iodevices_PUPDevice_read_obj) },
+    #if PBDRV_CONFIG_LEGODEV_PUP_UART_NUM_SAMPLES
+    { MP_ROM_QSTR(MP_QSTR_read_samples), MP_ROM_PTR(&iodevices_PUPDevice_read_samples_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_write),      MP_ROM_PTR(&iodevices_PUPDevice_write_obj)},
     { MP_ROM_QSTR(MP_QSTR_info),       MP_ROM_PTR(&iodevices_PUPDevice_info_obj)},
 };
@@ -16,6 +16,10 @@
 
 extern const mp_obj_type_t pb_type_drivebase;
 
+#if PYBRICKS_PY_ROBOTICS_MOTORGROUP
+extern const mp_obj_type_t pb_type_motorgroup;
+#endif
+
 #if PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE
 extern const mp_obj_type_t pb_type_spikebase;
 #endif
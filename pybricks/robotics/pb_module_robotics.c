@@ -11,6 +11,9 @@ STATIC const mp_rom_map_elem_t robotics_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__),    MP_ROM_QSTR(MP_QSTR_robotics)   },
     #if PYBRICKS_PY_COMMON_MOTORS
     { MP_ROM_QSTR(MP_QSTR_DriveBase),   MP_ROM_PTR(&pb_type_drivebase)  },
+    #if PYBRICKS_PY_ROBOTICS_MOTORGROUP
+    { MP_ROM_QSTR(MP_QSTR_MotorGroup),  MP_ROM_PTR(&pb_type_motorgroup) },
+    #endif
     #if PYBRICKS_PY_ROBOTICS_DRIVEBASE_SPIKE
     { MP_ROM_QSTR(MP_QSTR_SpikeBase),   MP_ROM_PTR(&pb_type_spikebase)  },
     #endif
@@ -114,6 +114,7 @@ STATIC mp_obj_t await_or_wait(pb_type_DriveBase_obj_t *self) {
         MP_OBJ_FROM_PTR(self),
         self->awaitables,
         pb_type_awaitable_end_time_none,
+        pb_type_awaitable_event_source_none,
         pb_type_DriveBase_test_completion,
         pb_type_awaitable_return_none,
         pb_type_DriveBase_cancel,
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2023 The Pybricks Authors
+
+#include "py/mpconfig.h"
+
+#if PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_MOTORGROUP
+
+#include <pbio/motion_group.h>
+
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#include <pybricks/common.h>
+#include <pybricks/parameters.h>
+#include <pybricks/robotics.h>
+#include <pybricks/tools/pb_type_awaitable.h>
+
+#include <pybricks/util_mp/pb_kwarg_helper.h>
+#include <pybricks/util_mp/pb_obj_helper.h>
+#include <pybricks/util_pb/pb_error.h>
+
+// pybricks.robotics.MotorGroup class object
+typedef struct _pb_type_MotorGroup_obj_t {
+    mp_obj_base_t base;
+    pbio_motion_group_t group;
+    mp_obj_t motors;
+    mp_obj_t awaitables;
+} pb_type_MotorGroup_obj_t;
+
+// pybricks.robotics.MotorGroup.__init__
+STATIC mp_obj_t pb_type_MotorGroup_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+
+    PB_PARSE_ARGS_CLASS(n_args, n_kw, args,
+        PB_ARG_REQUIRED(motors));
+
+    pb_type_MotorGroup_obj_t *self = mp_obj_malloc(pb_type_MotorGroup_obj_t, type);
+
+    size_t num_motors;
+    mp_obj_t *motors;
+    mp_obj_get_array(motors_in, &num_motors, &motors);
+
+    if (num_motors == 0 || num_motors > PBIO_CONFIG_SERVO_NUM_DEV) {
+        pb_assert(PBIO_ERROR_INVALID_ARG);
+    }
+
+    // Pointers to servos
+    pbio_servo_t *servos[PBIO_CONFIG_SERVO_NUM_DEV];
+    for (size_t i = 0; i < num_motors; i++) {
+        servos[i] = ((pb_type_Motor_obj_t *)pb_obj_get_base_class_obj(motors[i], &pb_type_Motor))->srv;
+    }
+    pb_assert(pbio_motion_group_setup(&self->group, servos, num_motors));
+
+    // Keep a reference to the motors so they are not garbage collected.
+    self->motors = mp_obj_new_tuple(num_motors, motors);
+
+    // List of awaitables associated with this group. By keeping track,
+    // we can cancel them as needed when a new movement is started.
+    self->awaitables = mp_obj_new_list(0, NULL);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC bool pb_type_MotorGroup_test_completion(mp_obj_t self_in, uint32_t end_time) {
+
+    pb_type_MotorGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // Handle I/O exceptions like port unplugged.
+    if (!pbio_motion_group_update_loop_is_running(&self->group)) {
+        pb_assert(PBIO_ERROR_NO_DEV);
+    }
+
+    // Get completion state.
+    return pbio_motion_group_is_done(&self->group);
+}
+
+STATIC void pb_type_MotorGroup_cancel(mp_obj_t self_in) {
+    pb_type_MotorGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_assert(pbio_motion_group_stop(&self->group, PBIO_CONTROL_ON_COMPLETION_COAST));
+}
+
+// Cancels awaitables of the individual motors, which would otherwise finish
+// when the group movement overrides them.
+STATIC void pb_type_MotorGroup_cancel_motor_awaitables(pb_type_MotorGroup_obj_t *self) {
+    size_t num_motors;
+    mp_obj_t *motors;
+    mp_obj_get_array(self->motors, &num_motors, &motors);
+    for (size_t i = 0; i < num_motors; i++) {
+        pb_type_Motor_obj_t *motor = MP_OBJ_TO_PTR(pb_obj_get_base_class_obj(motors[i], &pb_type_Motor));
+        pb_type_awaitable_update_all(motor->device_base.awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+    }
+}
+
+// Gets one integer value for each motor in the group.
+STATIC void pb_type_MotorGroup_get_values(pb_type_MotorGroup_obj_t *self, mp_obj_t values_in, int32_t *values) {
+    size_t num_values;
+    mp_obj_t *value_objs;
+    mp_obj_get_array(values_in, &num_values, &value_objs);
+    if (num_values != self->group.num_servos) {
+        mp_raise_ValueError(MP_ERROR_TEXT("need one value for each motor"));
+    }
+    for (size_t i = 0; i < num_values; i++) {
+        values[i] = pb_obj_get_int(value_objs[i]);
+    }
+}
+
+// Waits for the group to complete its maneuver, if requested.
+STATIC mp_obj_t pb_type_MotorGroup_await_or_wait(pb_type_MotorGroup_obj_t *self, mp_obj_t wait_in) {
+    // Old way to do parallel movement is to start and not wait on anything.
+    if (!mp_obj_is_true(wait_in)) {
+        return mp_const_none;
+    }
+    // Handle completion by awaiting or blocking.
+    return pb_type_awaitable_await_or_wait(
+        MP_OBJ_FROM_PTR(self),
+        self->awaitables,
+        pb_type_awaitable_end_time_none,
+        pb_type_awaitable_event_source_none,
+        pb_type_MotorGroup_test_completion,
+        pb_type_awaitable_return_none,
+        pb_type_MotorGroup_cancel,
+        PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+}
+
+// pybricks.robotics.MotorGroup.run_target
+STATIC mp_obj_t pb_type_MotorGroup_run_target(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_MotorGroup_obj_t, self,
+        PB_ARG_REQUIRED(speed),
+        PB_ARG_REQUIRED(target_angles),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_TRUE(wait));
+
+    mp_int_t speed = pb_obj_get_int(speed_in);
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    // Need one target for each motor.
+    int32_t targets[PBIO_CONFIG_SERVO_NUM_DEV];
+    pb_type_MotorGroup_get_values(self, target_angles_in, targets);
+
+    pb_type_MotorGroup_cancel_motor_awaitables(self);
+    pb_assert(pbio_motion_group_run_target(&self->group, speed, targets, then));
+
+    return pb_type_MotorGroup_await_or_wait(self, wait_in);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_MotorGroup_run_target_obj, 1, pb_type_MotorGroup_run_target);
+
+// pybricks.robotics.MotorGroup.run_targets
+STATIC mp_obj_t pb_type_MotorGroup_run_targets(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        pb_type_MotorGroup_obj_t, self,
+        PB_ARG_REQUIRED(speeds),
+        PB_ARG_REQUIRED(target_angles),
+        PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
+        PB_ARG_DEFAULT_TRUE(wait));
+
+    pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
+
+    // Need one speed and one target for each motor. All values are checked,
+    // and all trajectories are computed, before any motor is started.
+    int32_t speeds[PBIO_CONFIG_SERVO_NUM_DEV];
+    int32_t targets[PBIO_CONFIG_SERVO_NUM_DEV];
+    pb_type_MotorGroup_get_values(self, speeds_in, speeds);
+    pb_type_MotorGroup_get_values(self, target_angles_in, targets);
+
+    pb_type_MotorGroup_cancel_motor_awaitables(self);
+    pb_assert(pbio_motion_group_run_targets(&self->group, speeds, targets, then));
+
+    return pb_type_MotorGroup_await_or_wait(self, wait_in);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_MotorGroup_run_targets_obj, 1, pb_type_MotorGroup_run_targets);
+
+// pybricks.robotics.MotorGroup.stop
+STATIC mp_obj_t pb_type_MotorGroup_stop(mp_obj_t self_in) {
+
+    // Cancel awaitables.
+    pb_type_MotorGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    pb_type_awaitable_update_all(self->awaitables, PB_TYPE_AWAITABLE_OPT_CANCEL_ALL);
+
+    // Stop hardware.
+    pb_type_MotorGroup_cancel(self_in);
+
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotorGroup_stop_obj, pb_type_MotorGroup_stop);
+
+// pybricks.robotics.MotorGroup.done
+STATIC mp_obj_t pb_type_MotorGroup_done(mp_obj_t self_in) {
+    pb_type_MotorGroup_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(pbio_motion_group_is_done(&self->group));
+}
+MP_DEFINE_CONST_FUN_OBJ_1(pb_type_MotorGroup_done_obj, pb_type_MotorGroup_done);
+
+// dir(pybricks.robotics.MotorGroup)
+STATIC const mp_rom_map_elem_t pb_type_MotorGroup_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_run_target),       MP_ROM_PTR(&pb_type_MotorGroup_run_target_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run_targets),      MP_ROM_PTR(&pb_type_MotorGroup_run_targets_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop),             MP_ROM_PTR(&pb_type_MotorGroup_stop_obj)       },
+    { MP_ROM_QSTR(MP_QSTR_done),             MP_ROM_PTR(&pb_type_MotorGroup_done_obj)       },
+};
+STATIC MP_DEFINE_CONST_DICT(pb_type_MotorGroup_locals_dict, pb_type_MotorGroup_locals_dict_table);
+
+// type(pybricks.robotics.MotorGroup)
+MP_DEFINE_CONST_OBJ_TYPE(pb_type_motorgroup,
+    MP_QSTR_MotorGroup,
+    MP_TYPE_FLAG_NONE,
+    make_new, pb_type_MotorGroup_make_new,
+    locals_dict, &pb_type_MotorGroup_locals_dict);
+
+#endif // PYBRICKS_PY_ROBOTICS && PYBRICKS_PY_COMMON_MOTORS && PYBRICKS_PY_ROBOTICS_MOTORGROUP
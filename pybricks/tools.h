@@ -18,6 +18,47 @@ bool pb_module_tools_run_loop_is_active(void);
 
 void pb_module_tools_assert_blocking(void);
 
+/**
+ * What a pending awaitable must wait for before the run loop checks it again.
+ */
+typedef enum _pb_module_tools_wake_t {
+    /** Must be checked on every loop time. */
+    PB_MODULE_TOOLS_WAKE_POLL,
+    /** Need not be checked until its end time. */
+    PB_MODULE_TOOLS_WAKE_END_TIME,
+    /** Need not be checked until a ready event for it is posted. */
+    PB_MODULE_TOOLS_WAKE_EVENT,
+} pb_module_tools_wake_t;
+
+void pb_module_tools_run_loop_notify_pending(mp_obj_t awaitable, pb_module_tools_wake_t wake, uint32_t end_time);
+
+void pb_module_tools_run_loop_notify_ready(void);
+
+void pb_module_tools_run_loop_request_poll(void);
+
+mp_obj_t pb_module_tools_run_loop_handle_yield(mp_obj_t yielded);
+
+/**
+ * Garbage collection statistics of the run_task loop. Times are in
+ * microseconds.
+ */
+typedef struct _pb_module_tools_run_task_stats_t {
+    /** Number of run loop iterations. */
+    uint32_t num_iterations;
+    /** Number of garbage collections. */
+    uint32_t num_collections;
+    /** Time spent collecting garbage in the most recent iteration. */
+    uint32_t gc_time_last;
+    /** Longest time spent collecting garbage in one iteration. */
+    uint32_t gc_time_max;
+    /** Total time spent collecting garbage. */
+    uint32_t gc_time_total;
+} pb_module_tools_run_task_stats_t;
+
+const pb_module_tools_run_task_stats_t *pb_module_tools_run_task_get_stats(void);
+
+void pb_module_tools_run_task_reset_stats(void);
+
 void pb_module_tools_pbio_task_do_blocking(pbio_task_t *task, mp_int_t timeout);
 
 mp_obj_t pb_module_tools_pbio_task_wait_or_await(pbio_task_t *task);
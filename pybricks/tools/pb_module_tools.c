@@ -41,6 +41,80 @@ void pb_module_tools_assert_blocking(void) {
     }
 }
 
+// What the awaitables that are still pending in the current run loop
+// iteration are waiting for. This tells the run loop how long it may sleep.
+STATIC struct {
+    // Whether at least one task must be polled on the next loop time.
+    bool poll;
+    // Whether at least one awaitable completes at a known end time.
+    bool has_deadline;
+    // Earliest end time of awaitables that complete at their end time.
+    uint32_t deadline;
+    // Whether a ready event was posted for one of the awaitables.
+    bool ready;
+} run_loop_wake;
+
+STATIC void pb_module_tools_run_loop_wake_reset(void) {
+    run_loop_wake.poll = false;
+    run_loop_wake.has_deadline = false;
+    run_loop_wake.ready = false;
+}
+
+/**
+ * Informs the run loop that an awaitable is not yet complete.
+ *
+ * @param [in]  awaitable   The awaitable.
+ * @param [in]  wake        What it waits for before it must be checked again.
+ * @param [in]  end_time    End time of the awaitable (ms).
+ */
+void pb_module_tools_run_loop_notify_pending(mp_obj_t awaitable, pb_module_tools_wake_t wake, uint32_t end_time) {
+    if (wake == PB_MODULE_TOOLS_WAKE_POLL) {
+        run_loop_wake.poll = true;
+    } else if (wake == PB_MODULE_TOOLS_WAKE_END_TIME &&
+               (!run_loop_wake.has_deadline || (int32_t)(end_time - run_loop_wake.deadline) < 0)) {
+        run_loop_wake.has_deadline = true;
+        run_loop_wake.deadline = end_time;
+    }
+}
+
+/**
+ * Informs the run loop that a ready event was posted for a pending awaitable,
+ * so it should wake up.
+ */
+void pb_module_tools_run_loop_notify_ready(void) {
+    run_loop_wake.ready = true;
+}
+
+/**
+ * Requests that the run loop polls all tasks on the next loop time.
+ */
+void pb_module_tools_run_loop_request_poll(void) {
+    run_loop_wake.poll = true;
+}
+
+/**
+ * Handles the value that a task yielded when it was resumed.
+ *
+ * Pending awaitables yield themselves, so a task that yields one is blocked
+ * in an await on it. It cannot do anything else until that awaitable may be
+ * done, so it need not be resumed until then. A Task from multitask() also
+ * yields itself, and requests polling for its own tasks as needed. Any other
+ * value means the task may do something else when resumed, such as checking
+ * a stopwatch, so it must be polled.
+ *
+ * @param [in]  yielded     The value yielded by the task.
+ * @return                  The awaitable the task is blocked on, or MP_OBJ_NULL.
+ */
+mp_obj_t pb_module_tools_run_loop_handle_yield(mp_obj_t yielded) {
+    if (mp_obj_is_type(yielded, &pb_type_awaitable)) {
+        return yielded;
+    }
+    if (!mp_obj_is_type(yielded, &pb_type_Task)) {
+        pb_module_tools_run_loop_request_poll();
+    }
+    return MP_OBJ_NULL;
+}
+
 // The awaitables for the wait() function have no object associated with
 // it (unlike e.g. a motor), so we make a starting point here. These never
 // have to cancel each other so shouldn't need to be in a list, but this lets
@@ -74,10 +148,11 @@ STATIC mp_obj_t pb_module_tools_wait(size_t n_args, const mp_obj_t *pos_args, mp
         NULL, // wait functions are not associated with an object
         MP_STATE_PORT(wait_awaitables),
         mp_hal_ticks_ms() + (time < 0 ? 0 : time),
+        pb_type_awaitable_event_source_none,
         pb_module_tools_wait_test_completion,
         pb_type_awaitable_return_none,
         pb_type_awaitable_cancel_none,
-        PB_TYPE_AWAITABLE_OPT_NONE);
+        PB_TYPE_AWAITABLE_OPT_COMPLETES_AT_END_TIME);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_wait_obj, 0, pb_module_tools_wait);
 
@@ -145,6 +220,7 @@ mp_obj_t pb_module_tools_pbio_task_wait_or_await(pbio_task_t *task) {
         MP_OBJ_FROM_PTR(task),
         MP_STATE_PORT(pbio_task_awaitables),
         pb_type_awaitable_end_time_none,
+        pb_type_awaitable_event_source_none,
         pb_module_tools_pbio_task_test_completion,
         pb_type_awaitable_return_none,
         pb_type_awaitable_cancel_none,
@@ -169,40 +245,177 @@ STATIC mp_obj_t pb_module_tools_read_input_byte(void) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(pb_module_tools_read_input_byte_obj, pb_module_tools_read_input_byte);
 
+// Garbage collection statistics of the run loop, kept across run_task calls
+// so they can be inspected afterwards.
+STATIC pb_module_tools_run_task_stats_t run_task_stats;
+
+const pb_module_tools_run_task_stats_t *pb_module_tools_run_task_get_stats(void) {
+    return &run_task_stats;
+}
+
+void pb_module_tools_run_task_reset_stats(void) {
+    run_task_stats = (pb_module_tools_run_task_stats_t) { 0 };
+}
+
+// Garbage collection policy of the run loop. Collecting on every iteration
+// costs a full mark and sweep of the heap even if nothing was allocated, so
+// we only collect if a sizable part of the heap was allocated since the last
+// collection, or if there is enough idle time left in this iteration.
+//
+// The amount allocated since the last collection is read from the counter
+// that the garbage collector keeps on each allocation, on hubs that enable it.
+// Measuring it with gc_info() instead would scan the whole heap on every
+// iteration, so other hubs only collect in idle time.
+
+typedef struct {
+    // Collect regardless of idle time if this many bytes were allocated.
+    size_t threshold;
+    // Duration (us) of the last collection, used to predict the next one.
+    uint32_t duration_estimate;
+    // Maximum duration (us) of collections that run in idle time, or
+    // UINT32_MAX if unlimited.
+    uint32_t budget;
+} pb_module_tools_run_task_gc_t;
+
+STATIC void pb_module_tools_run_task_gc_collect(pb_module_tools_run_task_gc_t *policy) {
+    uint32_t start = mp_hal_ticks_us();
+    gc_collect();
+    uint32_t duration = mp_hal_ticks_us() - start;
+
+    policy->duration_estimate = duration;
+
+    run_task_stats.num_collections++;
+    run_task_stats.gc_time_last = duration;
+    run_task_stats.gc_time_total += duration;
+    if (duration > run_task_stats.gc_time_max) {
+        run_task_stats.gc_time_max = duration;
+    }
+}
+
+/**
+ * Collects garbage if the run loop policy says it is time to do so.
+ *
+ * @param [in]  policy      The garbage collection policy state.
+ * @param [in]  idle_time   Time (us) left until the next iteration.
+ */
+STATIC void pb_module_tools_run_task_gc_update(pb_module_tools_run_task_gc_t *policy, uint32_t idle_time) {
+
+    run_task_stats.num_iterations++;
+    run_task_stats.gc_time_last = 0;
+
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    // This is reset on every collection, including those not started here.
+    size_t allocated = MP_STATE_MEM(gc_alloc_amount) * MICROPY_BYTES_PER_GC_BLOCK;
+
+    // Nothing to collect if nothing was allocated.
+    if (allocated == 0) {
+        return;
+    }
+    #else
+    // Unknown, but the allocator still collects by itself if the heap is full.
+    size_t allocated = 0;
+    #endif
+
+    // Collect if enough was allocated, or if it fits in the idle time and
+    // in the user budget, if any.
+    if (allocated >= policy->threshold ||
+        (policy->duration_estimate < idle_time && policy->duration_estimate <= policy->budget)) {
+        pb_module_tools_run_task_gc_collect(policy);
+    }
+}
+
 STATIC mp_obj_t pb_module_tools_run_task(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
         PB_ARG_REQUIRED(task),
-        PB_ARG_DEFAULT_INT(loop_time, 10));
+        PB_ARG_DEFAULT_INT(loop_time, 10),
+        PB_ARG_DEFAULT_NONE(gc_budget));
+
+    uint32_t loop_time = pb_obj_get_positive_int(loop_time_in);
+
+    // Budget in microseconds. Budgets too large to represent are unlimited.
+    uint32_t gc_budget = UINT32_MAX;
+    if (gc_budget_in != mp_const_none) {
+        mp_int_t gc_budget_ms = pb_obj_get_positive_int(gc_budget_in);
+        if ((mp_uint_t)gc_budget_ms < UINT32_MAX / 1000) {
+            gc_budget = gc_budget_ms * 1000;
+        }
+    }
+
+    // Collect up front so we start measuring allocations from a clean heap.
+    gc_info_t info;
+    gc_info(&info);
+    pb_module_tools_run_task_gc_t policy = {
+        .threshold = info.total / 16,
+        .budget = gc_budget,
+    };
+    pb_module_tools_run_task_gc_collect(&policy);
 
     run_loop_is_active = true;
+    pb_type_awaitable_events_start();
 
     uint32_t start_time = mp_hal_ticks_ms();
-    uint32_t loop_time = pb_obj_get_positive_int(loop_time_in);
 
     mp_obj_iter_buf_t iter_buf;
     mp_obj_t iterable = mp_getiter(task_in, &iter_buf);
 
+    // The awaitable that the task is blocked on, if any.
+    mp_obj_t waiting_on = MP_OBJ_NULL;
+
     nlr_buf_t nlr;
     if (nlr_push(&nlr) == 0) {
 
-        while (mp_iternext(iterable) != MP_OBJ_STOP_ITERATION) {
+        for (;;) {
 
-            gc_collect();
+            pb_module_tools_run_loop_wake_reset();
+
+            // Resume the task unless it waits on an awaitable that can't be
+            // done yet.
+            if (waiting_on == MP_OBJ_NULL || !pb_type_awaitable_defer(waiting_on)) {
+                mp_obj_t result = mp_iternext(iterable);
+                if (result == MP_OBJ_STOP_ITERATION) {
+                    break;
+                }
+
+                waiting_on = pb_module_tools_run_loop_handle_yield(result);
+            }
 
             if (loop_time == 0) {
+                // No idle time, so only collect if allocation requires it.
+                pb_module_tools_run_task_gc_update(&policy, 0);
                 continue;
             }
 
-            uint32_t elapsed = mp_hal_ticks_ms() - start_time;
-            if (elapsed < loop_time) {
-                mp_hal_delay_ms(loop_time - elapsed);
+            // Wake up on the next loop time, unless all pending awaitables
+            // complete at a known time or on a ready event. Then we can sleep
+            // until the earliest end time or event. The event loop keeps
+            // running while we sleep, so hardware and stop button events are
+            // still handled.
+            uint32_t wake_time = start_time + loop_time;
+            bool wake_on_time = true;
+            if (!run_loop_wake.poll) {
+                if (!run_loop_wake.has_deadline) {
+                    wake_on_time = false;
+                } else if ((int32_t)(run_loop_wake.deadline - wake_time) > 0) {
+                    wake_time = run_loop_wake.deadline;
+                }
             }
-            start_time += loop_time;
+
+            int32_t idle_time = wake_on_time ? (int32_t)(wake_time - mp_hal_ticks_ms()) : (int32_t)loop_time;
+            pb_module_tools_run_task_gc_update(&policy, idle_time > 0 ? idle_time * 1000 : 0);
+
+            while (!run_loop_wake.ready && (!wake_on_time || (int32_t)(wake_time - mp_hal_ticks_ms()) > 0)) {
+                MICROPY_EVENT_POLL_HOOK
+            }
+
+            // Start the next period now if woken up early by an event.
+            start_time = run_loop_wake.ready ? mp_hal_ticks_ms() : wake_time;
         }
 
         nlr_pop();
+        pb_type_awaitable_events_stop();
         run_loop_is_active = false;
     } else {
+        pb_type_awaitable_events_stop();
         run_loop_is_active = false;
         nlr_jump(nlr.ret_val);
     }
@@ -215,6 +428,7 @@ void pb_module_tools_init(void) {
     MP_STATE_PORT(wait_awaitables) = mp_obj_new_list(0, NULL);
     MP_STATE_PORT(pbio_task_awaitables) = mp_obj_new_list(0, NULL);
     run_loop_is_active = false;
+    pb_module_tools_run_task_reset_stats();
 }
 
 #if PYBRICKS_PY_TOOLS_HUB_MENU
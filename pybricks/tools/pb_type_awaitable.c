@@ -10,12 +10,18 @@
 #include "py/obj.h"
 #include "py/runtime.h"
 
+#include <pbio/event.h>
+
 #include <pybricks/tools.h>
 #include <pybricks/tools/pb_type_awaitable.h>
 
 // The awaitable object is free to be reused.
 #define AWAITABLE_FREE (NULL)
 
+// Maximum number of awaitables that can wait for ready events at once. Any
+// others are polled instead.
+#define AWAITABLE_NUM_EVENT_SLOTS (8)
+
 struct _pb_type_awaitable_obj_t {
     mp_obj_base_t base;
     /**
@@ -40,12 +46,128 @@ struct _pb_type_awaitable_obj_t {
      * Called on cancellation.
      */
     pb_type_awaitable_cancel_t cancel;
+    /**
+     * Whether this awaitable completes at its end time and not before.
+     */
+    bool completes_at_end_time;
+    /**
+     * Object whose ready event may complete this awaitable, or NULL if it
+     * is polled.
+     */
+    const void *event_source;
+    /**
+     * Whether a ready event was posted since the last completion test.
+     */
+    bool ready;
 };
 
+// Awaitables that are waiting for a ready event.
+MP_REGISTER_ROOT_POINTER(mp_obj_t awaitable_event_slots[AWAITABLE_NUM_EVENT_SLOTS]);
+
+/**
+ * Marks awaitables that wait on @p source as ready and wakes up the run loop.
+ *
+ * @param [in]  source      The object that is now ready.
+ */
+STATIC void pb_type_awaitable_ready_handler(const void *source) {
+    for (size_t i = 0; i < AWAITABLE_NUM_EVENT_SLOTS; i++) {
+        mp_obj_t slot = MP_STATE_PORT(awaitable_event_slots)[i];
+        if (slot == MP_OBJ_NULL) {
+            continue;
+        }
+        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(slot);
+        if (awaitable->event_source == source) {
+            awaitable->ready = true;
+            pb_module_tools_run_loop_notify_ready();
+        }
+    }
+}
+
+/**
+ * Starts handling ready events. Called when the run loop starts.
+ */
+void pb_type_awaitable_events_start(void) {
+    for (size_t i = 0; i < AWAITABLE_NUM_EVENT_SLOTS; i++) {
+        MP_STATE_PORT(awaitable_event_slots)[i] = MP_OBJ_NULL;
+    }
+    pbio_event_set_ready_handler(pb_type_awaitable_ready_handler);
+}
+
+/**
+ * Stops handling ready events. Called when the run loop ends.
+ *
+ * Awaitables that are still subscribed are polled if they are used again, and
+ * the slots no longer keep them from being garbage collected.
+ */
+void pb_type_awaitable_events_stop(void) {
+    pbio_event_set_ready_handler(NULL);
+    for (size_t i = 0; i < AWAITABLE_NUM_EVENT_SLOTS; i++) {
+        mp_obj_t slot = MP_STATE_PORT(awaitable_event_slots)[i];
+        if (slot == MP_OBJ_NULL) {
+            continue;
+        }
+        pb_type_awaitable_obj_t *awaitable = MP_OBJ_TO_PTR(slot);
+        awaitable->event_source = pb_type_awaitable_event_source_none;
+        MP_STATE_PORT(awaitable_event_slots)[i] = MP_OBJ_NULL;
+    }
+}
+
+/**
+ * Makes an awaitable wait for ready events from its event source instead of
+ * being polled, if there is a free slot.
+ *
+ * @param [in]  awaitable   The awaitable.
+ */
+STATIC void pb_type_awaitable_events_subscribe(pb_type_awaitable_obj_t *awaitable) {
+    for (size_t i = 0; i < AWAITABLE_NUM_EVENT_SLOTS; i++) {
+        if (MP_STATE_PORT(awaitable_event_slots)[i] == MP_OBJ_NULL) {
+            MP_STATE_PORT(awaitable_event_slots)[i] = MP_OBJ_FROM_PTR(awaitable);
+            return;
+        }
+    }
+    // No slot available, so it will be polled.
+    awaitable->event_source = pb_type_awaitable_event_source_none;
+}
+
+/**
+ * Stops an awaitable from waiting for ready events.
+ *
+ * @param [in]  awaitable   The awaitable.
+ */
+STATIC void pb_type_awaitable_events_unsubscribe(pb_type_awaitable_obj_t *awaitable) {
+    if (awaitable->event_source == pb_type_awaitable_event_source_none) {
+        return;
+    }
+    awaitable->event_source = pb_type_awaitable_event_source_none;
+    for (size_t i = 0; i < AWAITABLE_NUM_EVENT_SLOTS; i++) {
+        if (MP_STATE_PORT(awaitable_event_slots)[i] == MP_OBJ_FROM_PTR(awaitable)) {
+            MP_STATE_PORT(awaitable_event_slots)[i] = MP_OBJ_NULL;
+            return;
+        }
+    }
+}
+
+/**
+ * Informs the run loop that the awaitable is not yet complete, and when it
+ * needs to be checked again.
+ *
+ * @param [in]  self        The awaitable.
+ */
+STATIC void pb_type_awaitable_notify_pending(pb_type_awaitable_obj_t *self) {
+    pb_module_tools_wake_t wake = PB_MODULE_TOOLS_WAKE_POLL;
+    if (self->event_source) {
+        wake = PB_MODULE_TOOLS_WAKE_EVENT;
+    } else if (self->completes_at_end_time) {
+        wake = PB_MODULE_TOOLS_WAKE_END_TIME;
+    }
+    pb_module_tools_run_loop_notify_pending(MP_OBJ_FROM_PTR(self), wake, self->end_time);
+}
+
 // close() cancels the awaitable.
 STATIC mp_obj_t pb_type_awaitable_close(mp_obj_t self_in) {
     pb_type_awaitable_obj_t *self = MP_OBJ_TO_PTR(self_in);
     self->test_completion = AWAITABLE_FREE;
+    pb_type_awaitable_events_unsubscribe(self);
     // Handle optional clean up/cancelling of hardware operation.
     if (self->cancel) {
         self->cancel(self->obj);
@@ -62,13 +184,18 @@ STATIC mp_obj_t pb_type_awaitable_iternext(mp_obj_t self_in) {
         return MP_OBJ_STOP_ITERATION;
     }
 
-    // Keep going if not completed by returning None.
+    // Keep going if not completed by yielding this awaitable instead of None.
+    // If a task yields it to the run loop, it is blocked in an await on it.
+    // Let the run loop know when we need to be checked again.
+    self->ready = false;
     if (!self->test_completion(self->obj, self->end_time)) {
-        return mp_const_none;
+        pb_type_awaitable_notify_pending(self);
+        return self_in;
     }
 
     // Complete, so unset callback.
     self->test_completion = AWAITABLE_FREE;
+    pb_type_awaitable_events_unsubscribe(self);
 
     // For no return value, return basic stop iteration.
     if (!self->return_value) {
@@ -92,6 +219,36 @@ MP_DEFINE_CONST_OBJ_TYPE(pb_type_awaitable,
     iter, pb_type_awaitable_iternext,
     locals_dict, &pb_type_awaitable_locals_dict);
 
+/**
+ * Checks whether iterating the awaitable can be deferred because it cannot
+ * be complete yet. If so, the run loop is informed that it is still pending.
+ *
+ * This lets the run loop skip resuming tasks that wait on awaitables that
+ * did not change.
+ *
+ * @param [in]  awaitable_in    The awaitable.
+ * @return                      True if it can be deferred, false if it must be iterated.
+ */
+bool pb_type_awaitable_defer(mp_obj_t awaitable_in) {
+    if (!mp_obj_is_type(awaitable_in, &pb_type_awaitable)) {
+        return false;
+    }
+    pb_type_awaitable_obj_t *self = MP_OBJ_TO_PTR(awaitable_in);
+
+    bool deferred =
+        // Still in use, so not completed or cancelled.
+        self->test_completion != AWAITABLE_FREE &&
+        // Waiting for an event that has not happened yet.
+        ((self->event_source && !self->ready) ||
+         // Waiting for an end time that has not passed yet.
+         (!self->event_source && self->completes_at_end_time && (int32_t)(mp_hal_ticks_ms() - self->end_time) < 0));
+
+    if (deferred) {
+        pb_type_awaitable_notify_pending(self);
+    }
+    return deferred;
+}
+
 /**
  * Gets an awaitable object that is not in use, or makes a new one.
  *
@@ -113,6 +270,7 @@ STATIC pb_type_awaitable_obj_t *pb_type_awaitable_get(mp_obj_t awaitables_in) {
     // Otherwise allocate a new one.
     pb_type_awaitable_obj_t *awaitable = mp_obj_malloc(pb_type_awaitable_obj_t, &pb_type_awaitable);
     awaitable->test_completion = AWAITABLE_FREE;
+    awaitable->event_source = pb_type_awaitable_event_source_none;
 
     // Add to list of awaitables.
     mp_obj_list_append(awaitables_in, MP_OBJ_FROM_PTR(awaitable));
@@ -167,6 +325,8 @@ void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_
         // next iteration.
         if (options & PB_TYPE_AWAITABLE_OPT_CANCEL_ALL) {
             awaitable->test_completion = pb_type_awaitable_completed;
+            awaitable->ready = true;
+            pb_module_tools_run_loop_request_poll();
         }
 
     }
@@ -181,6 +341,8 @@ void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_
  * @param [in] awaitables_in         List of awaitables associated with @p obj.
  * @param [in] end_time              Wall time in milliseconds when the operation should end.
  *                                   May be arbitrary if completion function does not need it.
+ * @param [in] event_source          Object that posts a ready event when the operation may
+ *                                   be complete, or NULL if the operation must be polled.
  * @param [in] test_completion_func  Function to test if the operation is complete.
  * @param [in] return_value_func     Function that gets the return value for the awaitable.
  * @param [in] cancel_func           Function to cancel the hardware operation.
@@ -190,6 +352,7 @@ mp_obj_t pb_type_awaitable_await_or_wait(
     mp_obj_t obj,
     mp_obj_t awaitables_in,
     uint32_t end_time,
+    const void *event_source,
     pb_type_awaitable_test_completion_t test_completion_func,
     pb_type_awaitable_return_t return_value_func,
     pb_type_awaitable_cancel_t cancel_func,
@@ -215,6 +378,12 @@ mp_obj_t pb_type_awaitable_await_or_wait(
         awaitable->return_value = return_value_func;
         awaitable->cancel = cancel_func;
         awaitable->end_time = end_time;
+        awaitable->completes_at_end_time = options & PB_TYPE_AWAITABLE_OPT_COMPLETES_AT_END_TIME;
+        awaitable->ready = false;
+        if (event_source) {
+            awaitable->event_source = event_source;
+            pb_type_awaitable_events_subscribe(awaitable);
+        }
         return MP_OBJ_FROM_PTR(awaitable);
     }
 
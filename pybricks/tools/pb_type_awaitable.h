@@ -39,13 +39,22 @@ typedef enum _pb_type_awaitable_opt_t {
      * do not support graceful cancellation.
      */
     PB_TYPE_AWAITABLE_OPT_RAISE_ON_BUSY = 1 << 4,
+    /**
+     * Indicates that the awaitable completes at its end time and not before,
+     * so the run loop does not need to poll it until then.
+     */
+    PB_TYPE_AWAITABLE_OPT_COMPLETES_AT_END_TIME = 1 << 5,
 } pb_type_awaitable_opt_t;
 
 /**
  * A generator-like type for waiting on some operation to complete.
+ *
+ * While the operation is pending, iterating it yields the awaitable itself.
  */
 typedef struct _pb_type_awaitable_obj_t pb_type_awaitable_obj_t;
 
+extern const mp_obj_type_t pb_type_awaitable;
+
 /**
  * Tests if awaitable operation is complete.
  *
@@ -82,12 +91,21 @@ typedef void (*pb_type_awaitable_cancel_t)(mp_obj_t obj);
 
 #define pb_type_awaitable_cancel_none (NULL)
 
+#define pb_type_awaitable_event_source_none (NULL)
+
+void pb_type_awaitable_events_start(void);
+
+void pb_type_awaitable_events_stop(void);
+
+bool pb_type_awaitable_defer(mp_obj_t awaitable_in);
+
 void pb_type_awaitable_update_all(mp_obj_t awaitables_in, pb_type_awaitable_opt_t options);
 
 mp_obj_t pb_type_awaitable_await_or_wait(
     mp_obj_t obj,
     mp_obj_t awaitables_in,
     uint32_t end_time,
+    const void *event_source,
     pb_type_awaitable_test_completion_t test_completion_func,
     pb_type_awaitable_return_t return_value_func,
     pb_type_awaitable_cancel_t cancel_func,
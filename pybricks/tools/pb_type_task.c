@@ -12,6 +12,7 @@
 #include <pybricks/parameters.h>
 #include <pybricks/common.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_awaitable.h>
 
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
@@ -24,6 +25,10 @@ typedef struct {
     mp_obj_t return_val;
     mp_obj_iter_buf_t iter_buf;
     mp_obj_t iterable;
+    /**
+     * The awaitable that the task is blocked on, if any.
+     */
+    mp_obj_t waiting_on;
     bool done;
 } pb_type_Task_progress_t;
 
@@ -84,37 +89,46 @@ STATIC mp_obj_t pb_type_Task_iternext(mp_obj_t self_in) {
                 continue;
             }
 
+            // Skip this task if it waits on an awaitable that can't be done
+            // yet, so we don't resume coroutines that can't make progress.
+            if (task->waiting_on != MP_OBJ_NULL && pb_type_awaitable_defer(task->waiting_on)) {
+                continue;
+            }
+
             // Do one task iteration.
             mp_obj_t result = mp_iternext(task->iterable);
 
-            // Not done yet, try next time.
-            if (result == mp_const_none) {
+            // Not done yet, try next time. If it is blocked on an awaitable,
+            // remember it so we can skip this task until it may be done.
+            if (result != MP_OBJ_STOP_ITERATION) {
+                task->waiting_on = pb_module_tools_run_loop_handle_yield(result);
                 continue;
             }
+            task->waiting_on = MP_OBJ_NULL;
 
             // Task is done, save return value.
-            if (result == MP_OBJ_STOP_ITERATION) {
-                if (MP_STATE_THREAD(stop_iteration_arg) != MP_OBJ_NULL) {
-                    task->return_val = MP_STATE_THREAD(stop_iteration_arg);
-                }
-                task->done = true;
-                done_total++;
-
-                // If enough tasks are done, don't finish this round. This way,
-                // in race(), there is only one winner.
-                if (done_total >= self->num_tasks_required) {
-                    // Cancel everything else.
-                    pb_type_Task_close(self_in);
-                    break;
-                }
+            if (MP_STATE_THREAD(stop_iteration_arg) != MP_OBJ_NULL) {
+                task->return_val = MP_STATE_THREAD(stop_iteration_arg);
+            }
+            task->done = true;
+            done_total++;
+
+            // If enough tasks are done, don't finish this round. This way,
+            // in race(), there is only one winner.
+            if (done_total >= self->num_tasks_required) {
+                // Cancel everything else.
+                pb_type_Task_close(self_in);
+                break;
             }
         }
         // Successfully did one iteration of all tasks.
         nlr_pop();
 
-        // If collection not done yet, indicate that it should run again.
+        // If collection not done yet, indicate that it should run again. It
+        // yields itself so the run loop knows that it requests polling for
+        // its own tasks as needed.
         if (done_total < self->num_tasks_required) {
-            return mp_const_none;
+            return self_in;
         }
 
         // Otherwise raise StopIteration with return values.
@@ -149,6 +163,7 @@ STATIC mp_obj_t pb_type_Task_new(const mp_obj_type_t *type, size_t n_args, size_
         task->arg = args[i];
         task->return_val = mp_const_none;
         task->iterable = mp_getiter(args[i], &task->iter_buf);
+        task->waiting_on = MP_OBJ_NULL;
         task->done = false;
     }
     return MP_OBJ_FROM_PTR(self);
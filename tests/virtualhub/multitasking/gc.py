@@ -0,0 +1,38 @@
+from pybricks.experimental import run_task_stats
+from pybricks.tools import run_task
+
+
+def idle(n):
+    for i in range(n):
+        yield
+
+
+def allocate(n):
+    for i in range(n):
+        data = [i] * 1024
+        yield data
+
+
+# Nothing is allocated, so only the collection at the start should run.
+run_task_stats(reset=True)
+run_task(idle(100))
+stats = run_task_stats()
+print("idle", stats["iterations"] >= 100, stats["collections"])
+
+# Allocations are collected in idle time.
+run_task_stats(reset=True)
+run_task(allocate(100))
+stats = run_task_stats()
+print("allocate", stats["collections"] > 1)
+
+# Budgets that don't fit in microseconds are the same as no budget.
+run_task_stats(reset=True)
+run_task(allocate(100), gc_budget=10_000_000)
+stats = run_task_stats()
+print("large budget", stats["collections"] > 1)
+
+# Without idle time, only collect when much was allocated.
+run_task_stats(reset=True)
+run_task(allocate(100), loop_time=0)
+stats = run_task_stats()
+print("no idle time", stats["collections"] < 100)
@@ -0,0 +1,53 @@
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port
+from pybricks.tools import wait, multitask, run_task, StopWatch
+
+motor = Motor(Port.A)
+watch = StopWatch()
+
+
+# Awaits an awaitable directly, so the task is blocked until it is done.
+async def blocked(ms):
+    start = watch.time()
+    await wait(ms)
+    print("blocked done", watch.time() - start >= ms)
+
+
+# Iterates an awaitable by hand and gives up after a timeout, so the task
+# must keep running while the awaitable is pending.
+def with_timeout(awaitable, timeout):
+    start = watch.time()
+    while watch.time() - start < timeout:
+        try:
+            next(awaitable)
+        except StopIteration:
+            return True
+        yield
+    awaitable.close()
+    return False
+
+
+async def timeout_wait():
+    done = await with_timeout(wait(2000), 100)
+    print("wait done", done)
+
+
+async def timeout_motor():
+    start = watch.time()
+    done = await with_timeout(motor.run_target(100, 3600), 200)
+    print("motor done", done, watch.time() - start < 1000)
+
+
+async def finish_before_timeout():
+    done = await with_timeout(wait(50), 1000)
+    print("short wait done", done)
+
+
+async def main():
+    await multitask(blocked(500), timeout_wait())
+    await timeout_motor()
+    await finish_before_timeout()
+    await blocked(100)
+
+
+run_task(main())
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2023 The Pybricks Authors
+
+"""
+Pybricks binary log decoding tool.
+
+Converts a log saved with ``Logger.save(binary=True)`` to comma separated
+values, in the same format as ``Logger.save()``.
+
+The input may be the raw binary file (saved on ev3dev or the virtual hub) or
+the base64 text received from the hub via stdout.
+
+Binary format:
+    magic       4 bytes     b"PBLG"
+    version     uint8       1
+    num_cols    uint8       number of columns
+    num_rows    uint32      number of rows, little endian
+    encoding    uint8       one per column, 1 = delta
+    rows        varint      num_rows * num_cols values
+
+Each value is the zig-zag encoded variable length integer of the difference
+with the same column in the previous row. The first row is relative to zero.
+"""
+
+import argparse
+import base64
+import binascii
+import struct
+import sys
+from typing import Iterator, List, Tuple
+
+MAGIC = b"PBLG"
+VERSION = 1
+COLUMN_DELTA = 1
+HEADER_FORMAT = "<4sBBI"
+
+
+def read_varint(data: bytes, offset: int) -> Tuple[int, int]:
+    """Reads one zig-zag encoded varint.
+
+    Arguments:
+        data: The encoded data.
+        offset: Offset of the first byte of the varint.
+
+    Returns:
+        Tuple of the decoded value and the offset of the next varint.
+    """
+    result = 0
+    shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        result |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return (result >> 1) ^ -(result & 1), offset
+
+
+def to_int32(value: int) -> int:
+    """Wraps a value to the signed 32-bit range like the hub does."""
+    return (value + 0x80000000) % 0x100000000 - 0x80000000
+
+
+def decode(data: bytes) -> Iterator[List[int]]:
+    """Decodes a binary log.
+
+    Arguments:
+        data: The raw binary log or its base64 text representation.
+
+    Returns:
+        Iterator over the rows of the log.
+    """
+    if not data.startswith(MAGIC):
+        try:
+            data = base64.b64decode(b"".join(data.split()), validate=True)
+        except binascii.Error:
+            raise ValueError("not a Pybricks binary log")
+
+    magic, version, num_cols, num_rows = struct.unpack_from(HEADER_FORMAT, data)
+    if magic != MAGIC:
+        raise ValueError("not a Pybricks binary log")
+    if version != VERSION:
+        raise ValueError(f"unsupported log version {version}")
+
+    offset = struct.calcsize(HEADER_FORMAT)
+    encodings = data[offset : offset + num_cols]
+    offset += num_cols
+    if any(e != COLUMN_DELTA for e in encodings):
+        raise ValueError("unsupported column encoding")
+
+    row = [0] * num_cols
+    for _ in range(num_rows):
+        for col in range(num_cols):
+            delta, offset = read_varint(data, offset)
+            row[col] = to_int32(row[col] + delta)
+        yield list(row)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("input", metavar="<input>", help="the binary log file")
+    parser.add_argument(
+        "-o", "--output", metavar="<output>", help="the csv file (default: stdout)"
+    )
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        rows = decode(f.read())
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        for row in rows:
+            print(", ".join(str(v) for v in row), file=out)
+    finally:
+        if args.output:
+            out.close()
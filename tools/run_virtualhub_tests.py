@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2023 The Pybricks Authors
+
+"""
+Pybricks virtual hub parallel test runner.
+
+Runs each test script in its own virtual hub process, using as many processes
+at the same time as there are CPU cores. Each process runs in its own empty
+working directory, so tests cannot affect each other.
+
+The output of each test is compared with the ``.exp`` file next to it. Tests
+without an ``.exp`` file are skipped. For each test, the wall time it took is
+reported.
+
+The virtual hub must already be built, for example with ``make virtualhub``.
+
+This is a local tool for faster test runs during development. CI runs the
+tests with ``test-virtualhub.sh``. By default, tests run on the system clock
+like they do there. The ``--simulated-time`` option runs them in the opt-in
+simulated time mode instead.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import pathlib
+import re
+import subprocess
+import sys
+import tempfile
+import time
+from typing import List, NamedTuple, Optional
+
+TOP_DIR = pathlib.Path(__file__).resolve().parent.parent
+DEFAULT_TEST_DIR = TOP_DIR / "tests" / "virtualhub"
+DEFAULT_MICROPYTHON = TOP_DIR / "bricks" / "virtualhub" / "build" / "virtualhub-micropython"
+PBIO_CPYTHON_DIR = TOP_DIR / "lib" / "pbio" / "cpython"
+
+
+class Result(NamedTuple):
+    test: pathlib.Path
+    status: str
+    duration: float
+    output: bytes
+    expected: Optional[bytes]
+
+
+def find_tests(test_dirs: List[pathlib.Path], include: Optional[str]) -> List[pathlib.Path]:
+    """Finds all test scripts.
+
+    Arguments:
+        test_dirs: Directories that are searched recursively.
+        include: Regular expression that test paths must match, or None for all.
+
+    Returns:
+        Sorted list of test scripts.
+    """
+    tests = set()
+    for test_dir in test_dirs:
+        for test in test_dir.rglob("*.py"):
+            if "build" in test.relative_to(test_dir).parts:
+                continue
+            if include and not re.search(include, str(test)):
+                continue
+            tests.add(test.resolve())
+    return sorted(tests)
+
+
+def display_path(test: pathlib.Path) -> str:
+    """Gets the path of a test relative to the repository, if it is in it."""
+    try:
+        return str(test.relative_to(TOP_DIR))
+    except ValueError:
+        return str(test)
+
+
+def run_test(
+    test: pathlib.Path, micropython: pathlib.Path, timeout: float, simulated_time: bool
+) -> Result:
+    """Runs one test script in a new virtual hub process.
+
+    Arguments:
+        test: The test script.
+        micropython: The virtual hub executable.
+        timeout: Time after which the test is stopped and fails (s).
+        simulated_time: Whether to run in simulated time instead of on the system clock.
+
+    Returns:
+        The result of the test.
+    """
+    exp_file = test.with_name(test.name + ".exp")
+    if not exp_file.exists():
+        return Result(test, "skip", 0, b"", None)
+
+    expected = exp_file.read_bytes().replace(b"\r\n", b"\n")
+
+    env = dict(os.environ)
+    env.setdefault("PBIO_VIRTUAL_PLATFORM_MODULE", "pbio_virtual.platform.robot")
+    if simulated_time:
+        env["PBIO_VIRTUAL_SIMULATED_TIME"] = "1"
+    else:
+        env.pop("PBIO_VIRTUAL_SIMULATED_TIME", None)
+    env["PYTHONPATH"] = os.pathsep.join(filter(None, [str(PBIO_CPYTHON_DIR), env.get("PYTHONPATH")]))
+
+    with tempfile.TemporaryDirectory(prefix="virtualhub-") as work_dir:
+        start = time.monotonic()
+        try:
+            proc = subprocess.run(
+                [str(micropython), str(test)],
+                cwd=work_dir,
+                env=env,
+                stdin=subprocess.DEVNULL,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+                timeout=timeout,
+            )
+            output = proc.stdout.replace(b"\r\n", b"\n")
+        except subprocess.TimeoutExpired as ex:
+            output = (ex.output or b"") + b"TIMEOUT\n"
+        duration = time.monotonic() - start
+
+    status = "pass" if output == expected else "FAIL"
+    return Result(test, status, duration, output, expected)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip())
+    parser.add_argument(
+        "test_dirs",
+        metavar="DIR",
+        nargs="*",
+        type=pathlib.Path,
+        default=[DEFAULT_TEST_DIR],
+        help="directories with test scripts (default: tests/virtualhub)",
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=os.cpu_count(),
+        help="number of virtual hubs that run at the same time (default: number of CPUs)",
+    )
+    parser.add_argument(
+        "-i",
+        "--include",
+        metavar="REGEX",
+        help="only run tests with a path matching this regular expression",
+    )
+    parser.add_argument(
+        "--micropython",
+        type=pathlib.Path,
+        default=pathlib.Path(os.environ.get("MICROPY_MICROPYTHON", DEFAULT_MICROPYTHON)),
+        help="virtual hub executable",
+    )
+    parser.add_argument(
+        "--timeout",
+        type=float,
+        default=60,
+        help="time after which a single test fails (s, default: 60)",
+    )
+    parser.add_argument(
+        "--simulated-time",
+        action="store_true",
+        help="run tests in simulated time instead of on the system clock",
+    )
+    parser.add_argument(
+        "--print-failures",
+        action="store_true",
+        help="print expected and actual output of failed tests",
+    )
+    args = parser.parse_args()
+
+    if not args.micropython.exists():
+        parser.error(f"{args.micropython} not found, build it with `make virtualhub`")
+
+    tests = find_tests(args.test_dirs, args.include)
+
+    start = time.monotonic()
+    results: List[Result] = []
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.jobs)) as executor:
+        micropython = args.micropython.resolve()
+        futures = [executor.submit(run_test, test, micropython, args.timeout, args.simulated_time) for test in tests]
+        for future in concurrent.futures.as_completed(futures):
+            result = future.result()
+            results.append(result)
+            print(
+                f"{result.status} {result.duration:7.3f}s {display_path(result.test)}",
+                flush=True,
+            )
+
+    duration = time.monotonic() - start
+
+    failed = [r for r in results if r.status == "FAIL"]
+    passed = [r for r in results if r.status == "pass"]
+    skipped = [r for r in results if r.status == "skip"]
+
+    if args.print_failures:
+        for result in sorted(failed, key=lambda r: r.test):
+            print(f"\n{display_path(result.test)} expected:")
+            sys.stdout.write(result.expected.decode(errors="replace"))
+            print(f"\n{display_path(result.test)} output:")
+            sys.stdout.write(result.output.decode(errors="replace"))
+
+    print(
+        f"\n{len(passed)} passed, {len(failed)} failed, {len(skipped)} skipped "
+        f"in {duration:.3f}s using {args.jobs} jobs"
+    )
+    for result in sorted(failed, key=lambda r: r.test):
+        print(f"failed: {display_path(result.test)}")
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()